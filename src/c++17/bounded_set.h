@@ -0,0 +1,215 @@
+#pragma once
+
+#include "fast_set.h"
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+#ifdef _GLIBCXX_DEBUG
+#include <cassert>
+#endif
+
+// ordered set of integers in [0, n) with the ordered_set interface (find_by_order, order_of_key, iterators)
+// a Fast_set finds successors/predecessors in O(log_64 n) with ctz/clz,
+// a fenwick tree over the popcounts of cache line sized chunks of its words answers rank queries and selects by bit descent in O(log n)
+// about n / 8 bytes for the bits and n / 128 for the fenwick tree
+class Bounded_set {
+
+	using size_type = unsigned int;
+
+public:
+
+	using key_type = size_type;
+	using value_type = size_type;
+	using iterator = Fast_set::iterator;
+	using const_iterator = Fast_set::const_iterator;
+
+	static constexpr const size_type npos = Fast_set::npos;
+
+	inline Bounded_set(size_type _n = 0) :
+	m_bits(_n)
+	{
+		this->m_allocate();
+	}
+
+	// bit i of bitmap[i >> 6] tells whether i is in the set, in O(n / 64)
+	inline Bounded_set(size_type _n, const std::vector <unsigned long long>& bitmap) :
+	m_bits(_n, bitmap)
+	{
+		this->m_allocate();
+		this->m_rebuild();
+	}
+
+	// from keys in any order (duplicates are ignored), in O(n / 64 + number of keys)
+	template <typename IT> inline Bounded_set(size_type _n, IT first, IT last) :
+	m_bits(_n, first, last)
+	{
+		this->m_allocate();
+		this->m_rebuild();
+	}
+
+	inline size_type size() const noexcept {
+		return this->m_bits.size();
+	}
+
+	inline bool empty() const noexcept {
+		return this->m_bits.empty();
+	}
+
+	// the bound n, keys lie in [0, n)
+	inline size_type bound() const noexcept {
+		return this->m_bits.bound();
+	}
+
+	inline void clear() noexcept {
+		this->m_bits.clear();
+		std::fill(this->m_fenwick.begin(), this->m_fenwick.end(), 0U);
+	}
+
+	inline iterator begin() const noexcept {
+		return this->m_bits.begin();
+	}
+
+	inline iterator end() const noexcept {
+		return this->m_bits.end();
+	}
+
+	inline std::pair <iterator, bool> insert(size_type key) noexcept {
+		const std::pair <iterator, bool> result = this->m_bits.insert(key);
+		if (result.second) {
+			this->m_add(key >> 6 >> m_chunk_shift, 1);
+		}
+		return result;
+	}
+
+	// number of erased keys (0 or 1)
+	inline size_type erase(size_type key) noexcept {
+		if (!this->m_bits.erase(key)) {
+			return 0;
+		}
+		this->m_add(key >> 6 >> m_chunk_shift, static_cast <size_type> (-1));
+		return 1;
+	}
+
+	// the iterator following the erased key
+	inline iterator erase(iterator it) noexcept {
+		const size_type key = *it;
+		this->erase(key);
+		return this->lower_bound(key);
+	}
+
+	inline size_type count(size_type key) const noexcept {
+		return this->m_bits.count(key);
+	}
+
+	inline iterator find(size_type key) const noexcept {
+		return this->m_bits.find(key);
+	}
+
+	inline iterator lower_bound(size_type key) const noexcept {
+		return this->m_bits.lower_bound(key);
+	}
+
+	inline iterator upper_bound(size_type key) const noexcept {
+		return this->m_bits.upper_bound(key);
+	}
+
+	// smallest key >= key, npos if none
+	inline size_type next(size_type key) const noexcept {
+		return this->m_bits.next(key);
+	}
+
+	// largest key <= key, npos if none
+	inline size_type prev(size_type key) const noexcept {
+		return this->m_bits.prev(key);
+	}
+
+	// the order-th smallest key (0-indexed), end() if order >= size()
+	inline iterator find_by_order(size_type order) const noexcept {
+		if (order >= this->size()) {
+			return this->end();
+		}
+		size_type chunk = 0;
+		for (size_type step = this->m_step; step; step >>= 1) {
+			if (chunk + step <= this->m_chunks && this->m_fenwick[chunk + step] <= order) {
+				chunk += step;
+				order -= this->m_fenwick[chunk];
+			}
+		}
+		size_type word = chunk << m_chunk_shift;
+		for (size_type count; order >= (count = __builtin_popcountll(this->m_bits.word(word))); word++) {
+			order -= count;
+		}
+		return this->m_bits.find(word << 6 | m_select(this->m_bits.word(word), order));
+	}
+
+	// number of keys less than key
+	inline size_type order_of_key(size_type key) const noexcept {
+		if (key >= this->bound()) {
+			return this->size();
+		}
+		size_type result = __builtin_popcountll(this->m_bits.word(key >> 6) & ((1ULL << (key & 63)) - 1));
+		for (size_type word = key >> 6 >> m_chunk_shift << m_chunk_shift; word < key >> 6; word++) {
+			result += __builtin_popcountll(this->m_bits.word(word));
+		}
+		for (size_type i = key >> 6 >> m_chunk_shift; i; i &= i - 1) {
+			result += this->m_fenwick[i];
+		}
+		return result;
+	}
+
+private:
+
+	// a chunk is 2^m_chunk_shift words (one cache line), the fenwick tree is 1-indexed over the chunks
+	static constexpr const size_type m_chunk_shift = 3;
+
+	Fast_set m_bits;
+	size_type m_words;
+	size_type m_chunks;
+	// largest power of two <= m_chunks, where the bit descent starts
+	size_type m_step;
+	std::vector <size_type> m_fenwick;
+
+	inline void m_allocate() {
+		this->m_words = (this->bound() + 63) >> 6;
+		this->m_chunks = (this->m_words + (1U << m_chunk_shift) - 1) >> m_chunk_shift;
+		this->m_step = this->m_chunks ? 1U << (31 - __builtin_clz(this->m_chunks)) : 0;
+		this->m_fenwick.assign(static_cast <size_t> (this->m_chunks) + 1, 0U);
+	}
+
+	// recomputes the fenwick tree from the words in linear time
+	inline void m_rebuild() noexcept {
+		std::fill(this->m_fenwick.begin(), this->m_fenwick.end(), 0U);
+		for (size_type i = 0; i < this->m_words; i++) {
+			this->m_fenwick[(i >> m_chunk_shift) + 1] += __builtin_popcountll(this->m_bits.word(i));
+		}
+		for (size_type i = 1; i <= this->m_chunks; i++) {
+			const size_type parent = i + (i & -i);
+			if (parent <= this->m_chunks) {
+				this->m_fenwick[parent] += this->m_fenwick[i];
+			}
+		}
+	}
+
+	// adds delta to the popcount of chunk i (0-indexed)
+	inline void m_add(size_type i, size_type delta) noexcept {
+		for (i++; i <= this->m_chunks; i += i & -i) {
+			this->m_fenwick[i] += delta;
+		}
+	}
+
+	// position of the k-th (0-indexed) set bit of word, narrowing by halves
+	static inline size_type m_select(unsigned long long word, size_type k) noexcept {
+		size_type result = 0;
+		for (size_type half = 32; half; half >>= 1) {
+			const size_type low = __builtin_popcountll(word & ((1ULL << half) - 1));
+			if (k >= low) {
+				k -= low;
+				word >>= half;
+				result += half;
+			}
+		}
+		return result;
+	}
+
+};
@@ -0,0 +1,872 @@
+#pragma once
+
+#include <vector>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+#include <functional>
+#include <type_traits>
+#ifdef _GLIBCXX_DEBUG
+#include <cassert>
+#endif
+
+// order statistic b+ tree, a set when VALUE is void and a map otherwise
+// keys live sorted in leaves of a few cache lines, inner nodes keep the size of every child subtree
+// nodes are taken from two index based pools, links are 32-bit, so at most 2^32 - 1 keys
+// find_by_order() and order_of_key() behave like the pb_ds ordered_set/ordered_map ones
+// with MULTI, equal keys share one slot holding their count (and, for maps, their values in insertion order),
+// so duplicates cost neither extra comparisons nor tree height; sizes and orders count every copy
+// unlike pb_ds, insert() and erase() invalidate all iterators
+template <typename KEY, typename VALUE = void, typename COMPARISON = std::less <KEY>, bool MULTI = false> class Btree {
+
+	using index_type = unsigned int;
+
+	static constexpr const bool m_is_set = std::is_void_v <VALUE>;
+	// placeholder for the values of a set, never stored
+	using m_mapped = std::conditional_t <m_is_set, char, VALUE>;
+	// what a leaf slot holds besides its key
+	using m_stored = std::conditional_t <MULTI && !m_is_set, std::vector <m_mapped>, m_mapped>;
+
+	template <bool CONST> class m_iterator;
+
+public:
+
+	using size_type = size_t;
+	using key_type = KEY;
+	using mapped_type = VALUE;
+	using value_type = std::conditional_t <m_is_set, KEY, std::pair <KEY, m_mapped>>;
+	using iterator = m_iterator <false>;
+	using const_iterator = m_iterator <true>;
+
+	Btree(const COMPARISON& _comparison = COMPARISON()) :
+	m_comparison(_comparison)
+	{
+		this->clear();
+	}
+
+	// O(n) from sorted input, see build()
+	template <typename IT> Btree(IT first, IT last, const COMPARISON& _comparison = COMPARISON()) :
+	m_comparison(_comparison)
+	{
+		this->build(first, last);
+	}
+
+	size_type size() const noexcept {
+		return this->m_size;
+	}
+
+	bool empty() const noexcept {
+		return !this->m_size;
+	}
+
+	void clear() {
+		this->m_leaves.assign(1, m_leaf());
+		this->m_inners.clear();
+		this->m_free_leaves.clear();
+		this->m_free_inners.clear();
+		this->m_root = this->m_first = this->m_last = 0;
+		this->m_height = 0;
+		this->m_size = 0;
+	}
+
+	void reserve(size_type n) {
+		this->m_leaves.reserve(n / m_leaf_min + 1);
+		this->m_inners.reserve(n / m_leaf_min / m_inner_min + 1);
+	}
+
+	// replaces the contents in O(n), the input must be strictly increasing (non decreasing with MULTI)
+	// leaves and inner nodes are filled to 3/4 so the first inserts do not split right away
+	template <typename IT> void build(IT first, IT last) {
+		this->clear();
+		const size_type n = std::distance(first, last);
+		if (!n) {
+			return;
+		}
+		this->m_size = n;
+		size_type slots = n;
+		if constexpr (MULTI) {
+			slots = 1;
+			for (IT previous = first, it = std::next(first); it != last; previous = it++) {
+				slots += this->m_comparison(m_key_of(*previous), m_key_of(*it));
+			}
+		}
+		std::vector <index_type> nodes, counts;
+		std::vector <KEY> keys;
+		const size_type leaves = (slots + m_leaf_fill - 1) / m_leaf_fill;
+		this->m_leaves.resize(leaves);
+		for (size_type l = 0; l < leaves; l++) {
+			m_leaf& leaf = this->m_leaves[l];
+			leaf.size = static_cast <index_type> (slots / leaves + (l < slots % leaves));
+			leaf.prev = l ? static_cast <index_type> (l - 1) : m_null;
+			leaf.next = l + 1 < leaves ? static_cast <index_type> (l + 1) : m_null;
+			for (index_type i = 0; i < leaf.size; i++) {
+				leaf.keys[i] = m_key_of(*first);
+#ifdef _GLIBCXX_DEBUG
+				assert((!i && !l) || this->m_comparison(i ? leaf.keys[i - 1] : this->m_leaves[l - 1].keys[this->m_leaves[l - 1].size - 1], leaf.keys[i]));
+#endif
+				if constexpr (MULTI) {
+					leaf.counts[i] = 0;
+					for (; first != last && !this->m_comparison(leaf.keys[i], m_key_of(*first)); ++first) {
+						leaf.counts[i]++;
+						if constexpr (!m_is_set) {
+							leaf.values[i].push_back(first->second);
+						}
+					}
+				} else {
+					if constexpr (!m_is_set) {
+						leaf.values[i] = first->second;
+					}
+					++first;
+				}
+			}
+			nodes.push_back(static_cast <index_type> (l));
+			counts.push_back(m_leaf_total(leaf));
+			keys.push_back(leaf.keys[0]);
+		}
+		this->m_last = static_cast <index_type> (leaves - 1);
+		while (nodes.size() > 1) {
+			const size_type parents = (nodes.size() + m_inner_fill - 1) / m_inner_fill;
+			std::vector <index_type> next_nodes, next_counts;
+			std::vector <KEY> next_keys;
+			for (size_type p = 0, j = 0; p < parents; p++) {
+				const index_type index = this->m_new_inner();
+				m_inner& node = this->m_inners[index];
+				node.size = static_cast <index_type> (nodes.size() / parents + (p < nodes.size() % parents));
+				index_type total = 0;
+				for (index_type i = 0; i < node.size; i++, j++) {
+					node.keys[i] = keys[j];
+					node.children[i] = nodes[j];
+					total += node.counts[i] = counts[j];
+				}
+				next_nodes.push_back(index);
+				next_counts.push_back(total);
+				next_keys.push_back(node.keys[0]);
+			}
+			nodes.swap(next_nodes);
+			counts.swap(next_counts);
+			keys.swap(next_keys);
+			this->m_height++;
+		}
+		this->m_root = nodes[0];
+	}
+
+	iterator begin() noexcept {
+		return iterator(this, this->m_size ? this->m_first : m_null, 0, 0);
+	}
+
+	const_iterator begin() const noexcept {
+		return const_iterator(this, this->m_size ? this->m_first : m_null, 0, 0);
+	}
+
+	iterator end() noexcept {
+		return iterator(this, m_null, 0, 0);
+	}
+
+	const_iterator end() const noexcept {
+		return const_iterator(this, m_null, 0, 0);
+	}
+
+	// with MULTI the new copy goes after the equal keys already present, and only its iterator is returned
+	std::conditional_t <MULTI, iterator, std::pair <iterator, bool>> insert(const value_type& value) {
+		std::pair <iterator, bool> result;
+		if constexpr (m_is_set) {
+			result = this->m_insert(value, m_mapped());
+		} else {
+			result = this->m_insert(value.first, value.second);
+		}
+		if constexpr (MULTI) {
+			return result.first;
+		} else {
+			return result;
+		}
+	}
+
+	m_mapped& operator [] (const KEY& key) {
+		static_assert(!m_is_set && !MULTI, "operator [] requires a map");
+		const iterator it = this->m_insert(key, m_mapped()).first;
+		return this->m_leaves[it.m_leaf].values[it.m_index];
+	}
+
+	// number of erased keys, every copy of key is erased
+	size_type erase(const KEY& key) {
+		return this->m_erase(key, 0, true);
+	}
+
+	// erases a single copy of key, for maps the value inserted last, 0 if key is missing
+	size_type erase_one(const KEY& key) {
+		return this->m_erase(key, m_null, false);
+	}
+
+	// the iterator following the erased element
+	iterator erase(const_iterator it) {
+		const KEY key = this->m_leaves[it.m_leaf].keys[it.m_index];
+		const size_type order = this->order_of_key(key) + it.m_copy;
+		this->m_erase(key, it.m_copy, false);
+		return this->find_by_order(order);
+	}
+
+	iterator find(const KEY& key) {
+		return this->m_make <iterator> (this->m_find(key));
+	}
+
+	const_iterator find(const KEY& key) const {
+		return this->m_make <const_iterator> (this->m_find(key));
+	}
+
+	size_type count(const KEY& key) const {
+		const m_position at = this->m_find(key);
+		return at.leaf == m_null ? 0 : m_copies(this->m_leaves[at.leaf], at.index);
+	}
+
+	iterator lower_bound(const KEY& key) {
+		return this->m_make <iterator> (this->m_lower(key, false));
+	}
+
+	const_iterator lower_bound(const KEY& key) const {
+		return this->m_make <const_iterator> (this->m_lower(key, false));
+	}
+
+	iterator upper_bound(const KEY& key) {
+		return this->m_make <iterator> (this->m_lower(key, true));
+	}
+
+	const_iterator upper_bound(const KEY& key) const {
+		return this->m_make <const_iterator> (this->m_lower(key, true));
+	}
+
+	// the order-th smallest key (0-indexed), end() if order >= size()
+	iterator find_by_order(size_type order) {
+		return this->m_make <iterator> (this->m_by_order(order));
+	}
+
+	const_iterator find_by_order(size_type order) const {
+		return this->m_make <const_iterator> (this->m_by_order(order));
+	}
+
+	// number of keys less than key, the order of the first copy of key
+	size_type order_of_key(const KEY& key) const {
+		return this->m_order(key, false);
+	}
+
+	// number of keys not greater than key, one past the order of the last copy of key
+	size_type order_of_upper_bound(const KEY& key) const {
+		return this->m_order(key, true);
+	}
+
+private:
+
+	// leaves hold m_leaf_bytes of keys, inner nodes m_inner_cap children
+	static constexpr const size_t m_leaf_bytes = 512;
+	static constexpr const index_type m_leaf_cap = std::max <size_t> (8, m_leaf_bytes / sizeof(KEY));
+	static constexpr const index_type m_inner_cap = 32;
+	// below these sizes a node is merged with or refilled from a sibling
+	static constexpr const index_type m_leaf_min = m_leaf_cap / 4;
+	static constexpr const index_type m_inner_min = m_inner_cap / 4;
+	static constexpr const index_type m_leaf_fill = m_leaf_cap - m_leaf_cap / 4;
+	static constexpr const index_type m_inner_fill = m_inner_cap - m_inner_cap / 4;
+	// every inner node has at least m_inner_min children, so this is never reached
+	static constexpr const int m_max_height = 32;
+	static constexpr const index_type m_null = ~0U;
+
+	struct m_leaf_keys {
+		KEY keys[m_leaf_cap];
+		index_type size = 0;
+		index_type prev = m_null;
+		index_type next = m_null;
+	};
+
+	struct m_leaf_counts : m_leaf_keys {
+		index_type counts[m_leaf_cap];
+	};
+
+	using m_leaf_base = std::conditional_t <MULTI, m_leaf_counts, m_leaf_keys>;
+
+	struct m_leaf_values : m_leaf_base {
+		m_stored values[m_leaf_cap];
+	};
+
+	using m_leaf = std::conditional_t <m_is_set, m_leaf_base, m_leaf_values>;
+
+	// child i holds the keys k with keys[i] <= k < keys[i + 1], keys[0] equals the separator in the parent
+	struct m_inner {
+		KEY keys[m_inner_cap];
+		index_type children[m_inner_cap];
+		index_type counts[m_inner_cap];
+		index_type size = 0;
+	};
+
+	// slot index of leaf, and which copy of its key (always 0 without MULTI)
+	struct m_position {
+		index_type leaf;
+		index_type index;
+		index_type copy;
+	};
+
+	std::vector <m_leaf> m_leaves;
+	std::vector <m_inner> m_inners;
+	std::vector <index_type> m_free_leaves;
+	std::vector <index_type> m_free_inners;
+	index_type m_root;
+	index_type m_first;
+	index_type m_last;
+	// number of inner levels, the root is a leaf at height 0
+	int m_height;
+	size_type m_size;
+	COMPARISON m_comparison;
+
+	template <bool CONST> class m_iterator {
+
+		using tree_type = std::conditional_t <CONST, const Btree, Btree>;
+		using mapped_reference = std::conditional_t <CONST, const m_mapped&, m_mapped&>;
+
+	public:
+
+		using iterator_category = std::bidirectional_iterator_tag;
+		using difference_type = std::ptrdiff_t;
+		using value_type = typename Btree::value_type;
+		using reference = std::conditional_t <m_is_set, const KEY&, std::pair <const KEY&, mapped_reference>>;
+
+		// holds the pair of references for operator -> on maps
+		struct arrow {
+			reference ref;
+			const reference* operator -> () const noexcept {
+				return &this->ref;
+			}
+		};
+
+		using pointer = std::conditional_t <m_is_set, const KEY*, arrow>;
+
+		m_iterator() noexcept : m_tree(nullptr), m_leaf(m_null), m_index(0), m_copy(0) { }
+
+		m_iterator(tree_type* _tree, index_type _leaf, index_type _index, index_type _copy) noexcept :
+		m_tree(_tree), m_leaf(_leaf), m_index(_index), m_copy(_copy)
+		{ }
+
+		operator m_iterator <true> () const noexcept {
+			return m_iterator <true> (this->m_tree, this->m_leaf, this->m_index, this->m_copy);
+		}
+
+		reference operator * () const noexcept {
+			auto& leaf = this->m_tree->m_leaves[this->m_leaf];
+			if constexpr (m_is_set) {
+				return leaf.keys[this->m_index];
+			} else if constexpr (MULTI) {
+				return reference(leaf.keys[this->m_index], leaf.values[this->m_index][this->m_copy]);
+			} else {
+				return reference(leaf.keys[this->m_index], leaf.values[this->m_index]);
+			}
+		}
+
+		pointer operator -> () const noexcept {
+			if constexpr (m_is_set) {
+				return &**this;
+			} else {
+				return arrow { **this };
+			}
+		}
+
+		m_iterator& operator ++ () noexcept {
+			if constexpr (MULTI) {
+				if (++this->m_copy < this->m_tree->m_leaves[this->m_leaf].counts[this->m_index]) {
+					return *this;
+				}
+				this->m_copy = 0;
+			}
+			if (++this->m_index == this->m_tree->m_leaves[this->m_leaf].size) {
+				this->m_leaf = this->m_tree->m_leaves[this->m_leaf].next;
+				this->m_index = 0;
+			}
+			return *this;
+		}
+
+		m_iterator operator ++ (int) noexcept {
+			m_iterator result = *this;
+			++*this;
+			return result;
+		}
+
+		m_iterator& operator -- () noexcept {
+			if constexpr (MULTI) {
+				if (this->m_copy) {
+					this->m_copy--;
+					return *this;
+				}
+			}
+			if (this->m_leaf == m_null) {
+				this->m_leaf = this->m_tree->m_last;
+				this->m_index = this->m_tree->m_leaves[this->m_leaf].size;
+			} else if (!this->m_index) {
+				this->m_leaf = this->m_tree->m_leaves[this->m_leaf].prev;
+				this->m_index = this->m_tree->m_leaves[this->m_leaf].size;
+			}
+			this->m_index--;
+			this->m_copy = m_copies(this->m_tree->m_leaves[this->m_leaf], this->m_index) - 1;
+			return *this;
+		}
+
+		m_iterator operator -- (int) noexcept {
+			m_iterator result = *this;
+			--*this;
+			return result;
+		}
+
+		bool operator == (const m_iterator& rhs) const noexcept {
+			return this->m_leaf == rhs.m_leaf && this->m_index == rhs.m_index && this->m_copy == rhs.m_copy;
+		}
+
+		bool operator != (const m_iterator& rhs) const noexcept {
+			return !(*this == rhs);
+		}
+
+	private:
+
+		friend class Btree;
+
+		tree_type* m_tree;
+		index_type m_leaf;
+		index_type m_index;
+		index_type m_copy;
+
+	};
+
+	template <typename IT> IT m_make(m_position at) const noexcept {
+		return IT(const_cast <typename IT::tree_type*> (this), at.leaf, at.index, at.copy);
+	}
+
+	static const KEY& m_key_of(const value_type& value) noexcept {
+		if constexpr (m_is_set) {
+			return value;
+		} else {
+			return value.first;
+		}
+	}
+
+	static index_type m_copies(const m_leaf& leaf, index_type i) noexcept {
+		if constexpr (MULTI) {
+			return leaf.counts[i];
+		} else {
+			return 1;
+		}
+	}
+
+	// number of keys in leaf, counting copies
+	static index_type m_leaf_total(const m_leaf& leaf) noexcept {
+		if constexpr (MULTI) {
+			index_type result = 0;
+			for (index_type i = 0; i < leaf.size; i++) {
+				result += leaf.counts[i];
+			}
+			return result;
+		} else {
+			return leaf.size;
+		}
+	}
+
+	index_type m_new_leaf() {
+		if (!this->m_free_leaves.empty()) {
+			const index_type index = this->m_free_leaves.back();
+			this->m_free_leaves.pop_back();
+			this->m_leaves[index].size = 0;
+			return index;
+		}
+		this->m_leaves.emplace_back();
+		return static_cast <index_type> (this->m_leaves.size() - 1);
+	}
+
+	index_type m_new_inner() {
+		if (!this->m_free_inners.empty()) {
+			const index_type index = this->m_free_inners.back();
+			this->m_free_inners.pop_back();
+			this->m_inners[index].size = 0;
+			return index;
+		}
+		this->m_inners.emplace_back();
+		return static_cast <index_type> (this->m_inners.size() - 1);
+	}
+
+	// the child of node whose range contains key
+	index_type m_route(const m_inner& node, const KEY& key) const noexcept {
+		return static_cast <index_type> (std::upper_bound(node.keys + 1, node.keys + node.size, key, this->m_comparison) - node.keys) - 1;
+	}
+
+	index_type m_leaf_lower(const m_leaf& leaf, const KEY& key) const noexcept {
+		return static_cast <index_type> (std::lower_bound(leaf.keys, leaf.keys + leaf.size, key, this->m_comparison) - leaf.keys);
+	}
+
+	// the leaf whose range contains key, path[d] and pos[d] record the inner node and child taken at depth d
+	index_type m_descend(const KEY& key, index_type* path, index_type* pos) const noexcept {
+		index_type index = this->m_root;
+		for (int d = 0; d < this->m_height; d++) {
+			const m_inner& node = this->m_inners[index];
+			path[d] = index;
+			pos[d] = this->m_route(node, key);
+			index = node.children[pos[d]];
+		}
+		return index;
+	}
+
+	// the first key not less than key (greater than key if upper), end if none
+	m_position m_lower(const KEY& key, bool upper) const noexcept {
+		index_type index = this->m_root;
+		for (int d = 0; d < this->m_height; d++) {
+			const m_inner& node = this->m_inners[index];
+			index = node.children[this->m_route(node, key)];
+		}
+		const m_leaf& leaf = this->m_leaves[index];
+		const index_type p = static_cast <index_type> ((upper ?
+		std::upper_bound(leaf.keys, leaf.keys + leaf.size, key, this->m_comparison) :
+		std::lower_bound(leaf.keys, leaf.keys + leaf.size, key, this->m_comparison)) - leaf.keys);
+		if (p == leaf.size) {
+			return { leaf.next, 0, 0 };
+		}
+		return { index, p, 0 };
+	}
+
+	m_position m_find(const KEY& key) const noexcept {
+		const m_position at = this->m_lower(key, false);
+		if (at.leaf == m_null || this->m_comparison(key, this->m_leaves[at.leaf].keys[at.index])) {
+			return { m_null, 0, 0 };
+		}
+		return at;
+	}
+
+	m_position m_by_order(size_type order) const noexcept {
+		if (order >= this->m_size) {
+			return { m_null, 0, 0 };
+		}
+		index_type index = this->m_root;
+		for (int d = 0; d < this->m_height; d++) {
+			const m_inner& node = this->m_inners[index];
+			index_type i = 0;
+			while (order >= node.counts[i]) {
+				order -= node.counts[i++];
+			}
+			index = node.children[i];
+		}
+		if constexpr (MULTI) {
+			const m_leaf& leaf = this->m_leaves[index];
+			index_type i = 0;
+			while (order >= leaf.counts[i]) {
+				order -= leaf.counts[i++];
+			}
+			return { index, i, static_cast <index_type> (order) };
+		} else {
+			return { index, static_cast <index_type> (order), 0 };
+		}
+	}
+
+	size_type m_order(const KEY& key, bool upper) const noexcept {
+		size_type result = 0;
+		index_type index = this->m_root;
+		for (int d = 0; d < this->m_height; d++) {
+			const m_inner& node = this->m_inners[index];
+			const index_type i = this->m_route(node, key);
+			for (index_type j = 0; j < i; j++) {
+				result += node.counts[j];
+			}
+			index = node.children[i];
+		}
+		const m_leaf& leaf = this->m_leaves[index];
+		const index_type p = static_cast <index_type> ((upper ?
+		std::upper_bound(leaf.keys, leaf.keys + leaf.size, key, this->m_comparison) :
+		std::lower_bound(leaf.keys, leaf.keys + leaf.size, key, this->m_comparison)) - leaf.keys);
+		if constexpr (MULTI) {
+			for (index_type i = 0; i < p; i++) {
+				result += leaf.counts[i];
+			}
+			return result;
+		} else {
+			return result + p;
+		}
+	}
+
+	void m_leaf_move(m_leaf& dst, index_type di, m_leaf& src, index_type si, index_type count) {
+		std::move(src.keys + si, src.keys + si + count, dst.keys + di);
+		if constexpr (MULTI) {
+			std::copy(src.counts + si, src.counts + si + count, dst.counts + di);
+		}
+		if constexpr (!m_is_set) {
+			std::move(src.values + si, src.values + si + count, dst.values + di);
+		}
+	}
+
+	// moves the slots of leaf count places to the right
+	void m_leaf_shift(m_leaf& leaf, index_type count) {
+		std::move_backward(leaf.keys, leaf.keys + leaf.size, leaf.keys + leaf.size + count);
+		if constexpr (MULTI) {
+			std::copy_backward(leaf.counts, leaf.counts + leaf.size, leaf.counts + leaf.size + count);
+		}
+		if constexpr (!m_is_set) {
+			std::move_backward(leaf.values, leaf.values + leaf.size, leaf.values + leaf.size + count);
+		}
+	}
+
+	void m_leaf_insert(m_leaf& leaf, index_type p, const KEY& key, const m_mapped& value) {
+		std::move_backward(leaf.keys + p, leaf.keys + leaf.size, leaf.keys + leaf.size + 1);
+		leaf.keys[p] = key;
+		if constexpr (MULTI) {
+			std::copy_backward(leaf.counts + p, leaf.counts + leaf.size, leaf.counts + leaf.size + 1);
+			leaf.counts[p] = 1;
+		}
+		if constexpr (!m_is_set) {
+			std::move_backward(leaf.values + p, leaf.values + leaf.size, leaf.values + leaf.size + 1);
+			if constexpr (MULTI) {
+				leaf.values[p].assign(1, value);
+			} else {
+				leaf.values[p] = value;
+			}
+		}
+		leaf.size++;
+	}
+
+	void m_leaf_erase(m_leaf& leaf, index_type p) {
+		this->m_leaf_move(leaf, p, leaf, p + 1, leaf.size - p - 1);
+		leaf.size--;
+	}
+
+	void m_inner_move(m_inner& dst, index_type di, const m_inner& src, index_type si, index_type count) {
+		std::copy(src.keys + si, src.keys + si + count, dst.keys + di);
+		std::copy(src.children + si, src.children + si + count, dst.children + di);
+		std::copy(src.counts + si, src.counts + si + count, dst.counts + di);
+	}
+
+	void m_inner_insert(m_inner& node, index_type i, const KEY& key, index_type child, index_type count) {
+		std::copy_backward(node.keys + i, node.keys + node.size, node.keys + node.size + 1);
+		std::copy_backward(node.children + i, node.children + node.size, node.children + node.size + 1);
+		std::copy_backward(node.counts + i, node.counts + node.size, node.counts + node.size + 1);
+		node.keys[i] = key;
+		node.children[i] = child;
+		node.counts[i] = count;
+		node.size++;
+	}
+
+	void m_inner_erase(m_inner& node, index_type i) {
+		this->m_inner_move(node, i, node, i + 1, node.size - i - 1);
+		node.size--;
+	}
+
+	static index_type m_total(const m_inner& node) noexcept {
+		index_type result = 0;
+		for (index_type i = 0; i < node.size; i++) {
+			result += node.counts[i];
+		}
+		return result;
+	}
+
+	std::pair <iterator, bool> m_insert(const KEY& key, const m_mapped& value) {
+		index_type path[m_max_height], pos[m_max_height];
+		const index_type leaf = this->m_descend(key, path, pos);
+		index_type p = this->m_leaf_lower(this->m_leaves[leaf], key);
+		const bool found = p < this->m_leaves[leaf].size && !this->m_comparison(key, this->m_leaves[leaf].keys[p]);
+		if (!MULTI && found) {
+			return { iterator(this, leaf, p, 0), false };
+		}
+		this->m_size++;
+		for (int d = 0; d < this->m_height; d++) {
+			this->m_inners[path[d]].counts[pos[d]]++;
+		}
+		if constexpr (MULTI) {
+			if (found) {
+				m_leaf& node = this->m_leaves[leaf];
+				if constexpr (!m_is_set) {
+					node.values[p].push_back(value);
+				}
+				return { iterator(this, leaf, p, node.counts[p]++), true };
+			}
+		}
+		if (this->m_leaves[leaf].size < m_leaf_cap) {
+			this->m_leaf_insert(this->m_leaves[leaf], p, key, value);
+			return { iterator(this, leaf, p, 0), true };
+		}
+		// split the full leaf in halves, the upper half moves to a new leaf right after it
+		const index_type right = this->m_new_leaf();
+		m_leaf& l = this->m_leaves[leaf];
+		m_leaf& r = this->m_leaves[right];
+		constexpr index_type half = m_leaf_cap >> 1;
+		this->m_leaf_move(r, 0, l, half, m_leaf_cap - half);
+		r.size = m_leaf_cap - half;
+		l.size = half;
+		r.prev = leaf;
+		r.next = l.next;
+		(l.next == m_null ? this->m_last : this->m_leaves[l.next].prev) = right;
+		l.next = right;
+		iterator result(this, leaf, p, 0);
+		if (p <= half) {
+			this->m_leaf_insert(l, p, key, value);
+		} else {
+			this->m_leaf_insert(r, p - half, key, value);
+			result = iterator(this, right, p - half, 0);
+		}
+		// hand the new node to the parent, splitting full inner nodes on the way up
+		KEY separator = r.keys[0];
+		index_type child = right, left_count = m_leaf_total(l), right_count = m_leaf_total(r);
+		for (int d = this->m_height - 1; d >= 0; d--) {
+			const index_type i = pos[d] + 1;
+			this->m_inners[path[d]].counts[i - 1] = left_count;
+			if (this->m_inners[path[d]].size < m_inner_cap) {
+				this->m_inner_insert(this->m_inners[path[d]], i, separator, child, right_count);
+				return { result, true };
+			}
+			const index_type split = this->m_new_inner();
+			m_inner& a = this->m_inners[path[d]];
+			m_inner& b = this->m_inners[split];
+			constexpr index_type inner_half = m_inner_cap >> 1;
+			this->m_inner_move(b, 0, a, inner_half, m_inner_cap - inner_half);
+			b.size = m_inner_cap - inner_half;
+			a.size = inner_half;
+			if (i <= inner_half) {
+				this->m_inner_insert(a, i, separator, child, right_count);
+			} else {
+				this->m_inner_insert(b, i - inner_half, separator, child, right_count);
+			}
+			separator = b.keys[0];
+			child = split;
+			left_count = m_total(a);
+			right_count = m_total(b);
+		}
+		const index_type root = this->m_new_inner();
+		m_inner& node = this->m_inners[root];
+		node.size = 2;
+		node.keys[1] = separator;
+		node.children[0] = this->m_root;
+		node.children[1] = child;
+		node.counts[0] = left_count;
+		node.counts[1] = right_count;
+		this->m_root = root;
+		this->m_height++;
+		return { result, true };
+	}
+
+	// erases every copy of key if all, otherwise copy number copy (the last one if m_null), returns the number erased
+	size_type m_erase(const KEY& key, index_type copy, bool all) {
+		index_type path[m_max_height], pos[m_max_height];
+		const index_type leaf = this->m_descend(key, path, pos);
+		m_leaf& node = this->m_leaves[leaf];
+		const index_type p = this->m_leaf_lower(node, key);
+		if (p == node.size || this->m_comparison(key, node.keys[p])) {
+			return 0;
+		}
+		const index_type removed = all ? m_copies(node, p) : 1;
+		this->m_size -= removed;
+		for (int d = 0; d < this->m_height; d++) {
+			this->m_inners[path[d]].counts[pos[d]] -= removed;
+		}
+		if constexpr (MULTI) {
+			if (node.counts[p] > removed) {
+				node.counts[p]--;
+				if constexpr (!m_is_set) {
+					node.values[p].erase(node.values[p].begin() + std::min(copy, node.counts[p]));
+				}
+				return removed;
+			}
+		}
+		this->m_leaf_erase(node, p);
+		this->m_rebalance(path, pos);
+		return removed;
+	}
+
+	// fixes an underfull leaf at the end of path, and then every inner node that lost a child on the way up
+	// a node is merged with a sibling if both fit in one node, otherwise the two are split evenly
+	void m_rebalance(const index_type* path, const index_type* pos) {
+		int d = this->m_height - 1;
+		if (d < 0) {
+			return;
+		}
+		{
+			m_inner& parent = this->m_inners[path[d]];
+			const index_type i = pos[d];
+			if (this->m_leaves[parent.children[i]].size >= m_leaf_min) {
+				return;
+			}
+			const index_type j = i + 1 < parent.size ? i + 1 : i - 1;
+			const index_type li = std::min(i, j), ri = std::max(i, j);
+			const index_type left = parent.children[li], right = parent.children[ri];
+			m_leaf& a = this->m_leaves[left];
+			m_leaf& b = this->m_leaves[right];
+			if (a.size + b.size <= m_leaf_cap) {
+				this->m_leaf_move(a, a.size, b, 0, b.size);
+				a.size += b.size;
+				a.next = b.next;
+				(b.next == m_null ? this->m_last : this->m_leaves[b.next].prev) = left;
+				this->m_free_leaves.push_back(right);
+				parent.counts[li] += parent.counts[ri];
+				this->m_inner_erase(parent, ri);
+			} else {
+				const index_type total = a.size + b.size, target = total >> 1;
+				if (a.size < target) {
+					const index_type count = target - a.size;
+					this->m_leaf_move(a, a.size, b, 0, count);
+					this->m_leaf_move(b, 0, b, count, b.size - count);
+				} else {
+					const index_type count = a.size - target;
+					this->m_leaf_shift(b, count);
+					this->m_leaf_move(b, 0, a, target, count);
+				}
+				a.size = target;
+				b.size = total - target;
+				parent.keys[ri] = b.keys[0];
+				parent.counts[li] = m_leaf_total(a);
+				parent.counts[ri] = m_leaf_total(b);
+				return;
+			}
+		}
+		for (d--; d >= 0; d--) {
+			m_inner& parent = this->m_inners[path[d]];
+			const index_type i = pos[d];
+			if (this->m_inners[parent.children[i]].size >= m_inner_min) {
+				break;
+			}
+			const index_type j = i + 1 < parent.size ? i + 1 : i - 1;
+			const index_type li = std::min(i, j), ri = std::max(i, j);
+			const index_type left = parent.children[li], right = parent.children[ri];
+			m_inner& a = this->m_inners[left];
+			m_inner& b = this->m_inners[right];
+			b.keys[0] = parent.keys[ri];
+			if (a.size + b.size <= m_inner_cap) {
+				this->m_inner_move(a, a.size, b, 0, b.size);
+				a.size += b.size;
+				this->m_free_inners.push_back(right);
+				parent.counts[li] += parent.counts[ri];
+				this->m_inner_erase(parent, ri);
+			} else {
+				const index_type total = a.size + b.size, target = total >> 1;
+				if (a.size < target) {
+					const index_type count = target - a.size;
+					this->m_inner_move(a, a.size, b, 0, count);
+					this->m_inner_move(b, 0, b, count, b.size - count);
+				} else {
+					const index_type count = a.size - target;
+					std::copy_backward(b.keys, b.keys + b.size, b.keys + b.size + count);
+					std::copy_backward(b.children, b.children + b.size, b.children + b.size + count);
+					std::copy_backward(b.counts, b.counts + b.size, b.counts + b.size + count);
+					this->m_inner_move(b, 0, a, target, count);
+				}
+				a.size = target;
+				b.size = total - target;
+				parent.keys[ri] = b.keys[0];
+				parent.counts[li] = m_total(a);
+				parent.counts[ri] = m_total(b);
+				break;
+			}
+		}
+		// a root with a single child is dropped
+		while (this->m_height && this->m_inners[this->m_root].size == 1) {
+			this->m_free_inners.push_back(this->m_root);
+			this->m_root = this->m_inners[this->m_root].children[0];
+			this->m_height--;
+		}
+	}
+
+};
+
+template <typename KEY, typename COMPARISON = std::less <KEY>>
+using btree_set = Btree <KEY, void, COMPARISON>;
+
+template <typename KEY, typename VALUE, typename COMPARISON = std::less <KEY>>
+using btree_map = Btree <KEY, VALUE, COMPARISON>;
+
+template <typename KEY, typename COMPARISON = std::less <KEY>>
+using btree_multiset = Btree <KEY, void, COMPARISON, true>;
+
+template <typename KEY, typename VALUE, typename COMPARISON = std::less <KEY>>
+using btree_multimap = Btree <KEY, VALUE, COMPARISON, true>;
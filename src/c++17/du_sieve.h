@@ -0,0 +1,98 @@
+#pragma once
+
+#include "sieve.h"
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+// prefix sums S(x) = f(1) + ... + f(x) of a multiplicative function f at every x = n / i, in O(n^(2/3))
+// requires a g with g(1) = 1 such that the prefix sums of g and of h = f * g (dirichlet convolution) are cheap:
+// S(x) = H(x) - sum_{2 <= d <= x} g(d) S(x / d)
+// values up to limit come from a precomputed table, larger ones are kept in a flat array indexed by n / x
+// T is the value type, e.g. long long, __int128 or Mint (sum of phi up to 10^11 does not fit in 64 bits)
+template <typename T> class Du_sieve {
+
+	using value_type = unsigned long long;
+
+public:
+
+	// small[x] = S(x) for x <= limit = small.size() - 1 (at least 1), g_sum(x) and h_sum(x) are the prefix sums of g and h
+	template <typename G, typename H> Du_sieve(value_type _n, std::vector <T> _small, G&& g_sum, H&& h_sum) :
+	m_n(_n),
+	m_limit(_small.size() - 1),
+	m_small(std::move(_small)),
+	m_large(_n > this->m_limit ? _n / this->m_limit + 1 : 0)
+	{
+		// decreasing i, i.e. increasing x = n / i, so S(x / d) = S(n / (i d)) is already at m_large[i * d] when needed
+		for (value_type i = this->m_large.size(); i-- > 1; ) {
+			const value_type x = this->m_n / i;
+			if (this->m_n / x != i) {
+				// another index holds the same x, keep a copy so every index can be read directly
+				this->m_large[i] = this->m_large[this->m_n / x];
+				continue;
+			}
+			T result = h_sum(x);
+			for (value_type d = 2, next; d <= x; d = next) {
+				const value_type q = x / d;
+				next = x / q + 1;
+				result -= (g_sum(next - 1) - g_sum(d - 1)) * (q <= this->m_limit ? this->m_small[q] : this->m_large[i * d]);
+			}
+			this->m_large[i] = result;
+		}
+	}
+
+	// requires x = n / i for some i (x <= limit works for any x)
+	T operator () (value_type x) const noexcept {
+		return x <= this->m_limit ? this->m_small[x] : this->m_large[this->m_n / x];
+	}
+
+	// sum of phi(i) for 1 <= i <= n
+	static T phi_sum(value_type n) {
+		const Sieve sieve(m_table_size(n));
+		std::vector <T> small(sieve.size() + 1, T(0));
+		for (value_type x = 1; x <= sieve.size(); x++) {
+			small[x] = small[x - 1] + T(sieve.phi(x));
+		}
+		return Du_sieve <T> (n, std::move(small), [] (value_type x) -> T { return T(x); }, [] (value_type x) -> T {
+			// x (x + 1) / 2 without dividing in T
+			return x & 1 ? T(x) * T((x + 1) >> 1) : T(x >> 1) * T(x + 1);
+		}) (n);
+	}
+
+	// sum of mu(i) for 1 <= i <= n (mertens function)
+	static T mu_sum(value_type n) {
+		const Sieve sieve(m_table_size(n));
+		std::vector <T> small(sieve.size() + 1, T(0));
+		for (value_type x = 1; x <= sieve.size(); x++) {
+			small[x] = small[x - 1] + T(sieve.mu(x));
+		}
+		return Du_sieve <T> (n, std::move(small), [] (value_type x) -> T { return T(x); }, [] (value_type) -> T { return T(1); }) (n);
+	}
+
+private:
+
+	value_type m_n;
+	value_type m_limit;
+	std::vector <T> m_small;
+	std::vector <T> m_large;
+
+	// about n^(2/3), capped to keep the table (and the sieve behind it) in the tens of megabytes
+	static constexpr const value_type m_max_table = 1 << 23;
+
+	static unsigned int m_table_size(value_type n) noexcept {
+		const value_type size = std::cbrt(static_cast <double> (n)) * std::cbrt(static_cast <double> (n));
+		return static_cast <unsigned int> (std::max <value_type> (1, std::min({ n, size, m_max_table })));
+	}
+
+};
+
+// __int128 by default, the sum passes 2^63 around n = 5.5 * 10^9 (and h_sum's x (x + 1) / 2 around 4.3 * 10^9)
+template <typename T = __int128> inline T phi_sum(unsigned long long n) {
+	return Du_sieve <T>::phi_sum(n);
+}
+
+// |mu_sum(x)| stays far below sqrt(x) in practice, so long long holds every intermediate value
+template <typename T = long long> inline T mu_sum(unsigned long long n) {
+	return Du_sieve <T>::mu_sum(n);
+}
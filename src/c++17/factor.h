@@ -0,0 +1,23 @@
+#pragma once
+
+#include "factor_core.h"
+
+#include <vector>
+#include <utility>
+
+// global shorthands for Factor, kept out of factor_core.h so headers built on Factor (phi.h, mint.h, ...) do not add them
+constexpr bool is_prime(unsigned long long n) noexcept {
+	return Factor::is_prime(n);
+}
+
+inline std::vector <std::pair <unsigned long long, int>> factorize(unsigned long long n) {
+	return Factor::factorize(n);
+}
+
+inline std::vector <unsigned long long> divisors(unsigned long long n) {
+	return Factor::divisors(n);
+}
+
+constexpr unsigned long long divisor_count(unsigned long long n) noexcept {
+	return Factor::divisor_count(n);
+}
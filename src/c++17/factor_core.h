@@ -0,0 +1,211 @@
+#pragma once
+
+#include "montgomery.h"
+
+#include <vector>
+#include <numeric>
+#include <utility>
+#include <algorithm>
+
+// 64-bit primality testing and factorization, usable in constant expressions
+// is_prime() is a deterministic miller-rabin (7 bases cover every 64-bit integer)
+// composites left after trial division by small primes are split with brent's variant of pollard's rho
+// all modular arithmetic goes through Montgomery64
+class Factor {
+
+	using value_type = unsigned long long;
+
+public:
+
+	// a 64-bit value has at most 63 prime factors counted with multiplicity
+	static constexpr const int max_factors = 64;
+
+	static constexpr bool is_prime(value_type n) noexcept {
+		if (n < 2) {
+			return false;
+		}
+		for (const value_type p : m_small_primes) {
+			if (!(n % p)) {
+				return n == p;
+			}
+		}
+		if (n < m_trial_limit * m_trial_limit) {
+			return true;
+		}
+		const Montgomery64 mont(n);
+		const value_type one = mont.to(1), minus_one = mont.to(n - 1);
+		const int s = __builtin_ctzll(n - 1);
+		const value_type d = (n - 1) >> s;
+		for (const value_type a : { 2ULL, 325ULL, 9375ULL, 28178ULL, 450775ULL, 9780504ULL, 1795265022ULL }) {
+			if (!(a % n)) {
+				continue;
+			}
+			value_type x = m_pow(mont, mont.to(a % n), d);
+			if (x == one || x == minus_one) {
+				continue;
+			}
+			bool witness = true;
+			for (int i = 1; i < s && witness; i++) {
+				x = mont.mul(x, x);
+				witness = x != minus_one;
+			}
+			if (witness) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// writes the prime factors of n (with multiplicity) to out in increasing order and returns their count, 0 for n < 2
+	static constexpr int prime_factors(value_type n, value_type* out) noexcept {
+		int count = 0;
+		if (n < 2) {
+			return count;
+		}
+		for (const value_type p : m_small_primes) {
+			while (!(n % p)) {
+				out[count++] = p;
+				n /= p;
+			}
+		}
+		if (n > 1) {
+			m_split(n, out, count);
+		}
+		for (int i = 1; i < count; i++) {
+			for (int j = i; j > 0 && out[j - 1] > out[j]; j--) {
+				const value_type t = out[j];
+				out[j] = out[j - 1];
+				out[j - 1] = t;
+			}
+		}
+		return count;
+	}
+
+	static constexpr value_type phi(value_type n) noexcept {
+		value_type factors[max_factors] = { };
+		const int count = prime_factors(n, factors);
+		value_type result = n;
+		for (int i = 0; i < count; i++) {
+			if (!i || factors[i] != factors[i - 1]) {
+				result -= result / factors[i];
+			}
+		}
+		return result;
+	}
+
+	static constexpr value_type divisor_count(value_type n) noexcept {
+		if (!n) {
+			return 0;
+		}
+		value_type factors[max_factors] = { };
+		const int count = prime_factors(n, factors);
+		value_type result = 1;
+		for (int i = 0, j = 0; i < count; i = j) {
+			while (j < count && factors[j] == factors[i]) {
+				j++;
+			}
+			result *= j - i + 1;
+		}
+		return result;
+	}
+
+	// (prime, exponent) pairs in increasing order of the primes
+	static std::vector <std::pair <value_type, int>> factorize(value_type n) {
+		value_type factors[max_factors] = { };
+		const int count = prime_factors(n, factors);
+		std::vector <std::pair <value_type, int>> result;
+		for (int i = 0; i < count; i++) {
+			if (!i || factors[i] != factors[i - 1]) {
+				result.emplace_back(factors[i], 0);
+			}
+			result.back().second++;
+		}
+		return result;
+	}
+
+	// in increasing order
+	static std::vector <value_type> divisors(value_type n) {
+		if (!n) {
+			return { };
+		}
+		std::vector <value_type> result = { 1 };
+		result.reserve(divisor_count(n));
+		for (const std::pair <value_type, int>& factor : factorize(n)) {
+			const size_t size = result.size();
+			value_type power = 1;
+			for (int e = 0; e < factor.second; e++) {
+				power *= factor.first;
+				for (size_t i = 0; i < size; i++) {
+					result.push_back(result[i] * power);
+				}
+			}
+		}
+		std::sort(result.begin(), result.end());
+		return result;
+	}
+
+private:
+
+	static constexpr const value_type m_small_primes[] = { 2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47 };
+	// every composite below m_trial_limit^2 has a factor in m_small_primes
+	static constexpr const value_type m_trial_limit = 53;
+
+	static constexpr value_type m_pow(const Montgomery64& mont, value_type base, value_type exponent) noexcept {
+		value_type result = mont.to(1);
+		while (exponent) {
+			if (exponent & 1) {
+				result = mont.mul(result, base);
+			}
+			base = mont.mul(base, base);
+			exponent >>= 1;
+		}
+		return result;
+	}
+
+	// n > 1 has no prime factor below m_trial_limit
+	static constexpr void m_split(value_type n, value_type* out, int& count) noexcept {
+		if (is_prime(n)) {
+			out[count++] = n;
+			return;
+		}
+		const value_type d = m_rho(n);
+		m_split(d, out, count);
+		m_split(n / d, out, count);
+	}
+
+	// a non trivial factor of the odd composite n
+	static constexpr value_type m_rho(value_type n) noexcept {
+		const Montgomery64 mont(n);
+		// gcds are taken on products of batch differences at a time
+		constexpr const value_type batch = 128;
+		for (value_type c = 1; ; c++) {
+			const value_type cm = mont.to(c);
+			value_type x = 0, y = mont.to(2), ys = 0, q = mont.to(1), g = 1;
+			for (value_type r = 1; g == 1; r <<= 1) {
+				x = y;
+				for (value_type i = 0; i < r; i++) {
+					y = mont.add(mont.mul(y, y), cm);
+				}
+				for (value_type k = 0; k < r && g == 1; k += batch) {
+					ys = y;
+					for (value_type i = 0; i < batch && i < r - k; i++) {
+						y = mont.add(mont.mul(y, y), cm);
+						q = mont.mul(q, mont.sub(x, y));
+					}
+					g = std::gcd(q, n);
+				}
+			}
+			if (g == n) {
+				// the batch overshot, redo its steps one at a time
+				do {
+					ys = mont.add(mont.mul(ys, ys), cm);
+					g = std::gcd(mont.sub(x, ys), n);
+				} while (g == 1);
+			}
+			if (g != n) {
+				return g;
+			}
+		}
+	}
+
+};
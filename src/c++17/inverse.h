@@ -1,25 +1,153 @@
 #pragma once
 
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+#include <type_traits>
+
+// a * b mod m for 0 <= a, b < m, up to 64-bit types (wider intermediate products never overflow)
+template <typename A> inline A mul_mod(A a, A b, A m) noexcept {
+	if constexpr (sizeof(A) <= sizeof(unsigned int)) {
+		return static_cast <A> (static_cast <unsigned long long> (a) * static_cast <unsigned long long> (b) % static_cast <unsigned long long> (m));
+	} else {
+		return static_cast <A> (static_cast <unsigned __int128> (a) * static_cast <unsigned __int128> (b) % static_cast <unsigned __int128> (m));
+	}
+}
+
+// a^-1 mod b (extended euclid), 0 if a is not invertible or b < 2
+// the bezout coefficients stay within (-b, b), they are kept in a signed type (__int128 for unsigned 64-bit A)
 template <typename A> inline A inverse(A a, A b) noexcept {
 	if (b < static_cast <A> (2)) {
 		return static_cast <A> (0);
 	}
-	A b0 = b;
-	A x = static_cast <A> (1), y = static_cast <A> (0);
-	while (static_cast <A> (1) < a) {
-		if (!(static_cast <A> (0) < b)) {
-			return static_cast <A> (0);
+	using S = std::conditional_t <(static_cast <A> (-1) < static_cast <A> (0)), A,
+	std::conditional_t <(sizeof(A) < sizeof(long long)), long long, __int128>>;
+	if constexpr (sizeof(S) > sizeof(A) && sizeof(A) == sizeof(long long)) {
+		// 128-bit division is only needed for moduli from 2^63 on
+		if (!(b >> 63)) {
+			return static_cast <A> (inverse <long long> (static_cast <long long> (a % b), static_cast <long long> (b)));
 		}
-		A quo = a / b;
-		A t = b;
-		b = a % b;
-		a = t;
-		t = y;
-		y = x - quo * y;
-		x = t;
-	}
-	if (x < static_cast <A> (0)) {
-		x += b0;
-	}
-	return x;
+	}
+	S r0 = static_cast <S> (a) % static_cast <S> (b), r1 = static_cast <S> (b);
+	if (r0 < static_cast <S> (0)) {
+		r0 += r1;
+	}
+	S x0 = static_cast <S> (1), x1 = static_cast <S> (0);
+	while (r1 != static_cast <S> (0)) {
+		const S quo = r0 / r1;
+		S t = r0 - quo * r1;
+		r0 = r1;
+		r1 = t;
+		t = x0 - quo * x1;
+		x0 = x1;
+		x1 = t;
+	}
+	if (r0 != static_cast <S> (1)) {
+		return static_cast <A> (0);
+	}
+	return static_cast <A> (x0 < static_cast <S> (0) ? x0 + static_cast <S> (b) : x0);
+}
+
+// a^-1 mod m for unsigned A through binary gcd (shifts and subtractions, no division), 0 if a is not invertible
+// the halvings are deferred: the loop yields a^-1 * 2^k (kaliski's almost inverse) and 2^-k is applied at the end in 64-bit chunks
+// moduli that are even or not below 2^63 are handed to inverse()
+template <typename A> inline A inverse_binary(A a, A m) noexcept {
+	static_assert(static_cast <A> (0) < static_cast <A> (-1), "inverse_binary() requires an unsigned type");
+	if (!(m & 1) || static_cast <unsigned long long> (m) >> 63 || sizeof(A) > sizeof(unsigned long long)) {
+		return inverse(a, m);
+	}
+	const unsigned long long mod = m;
+	// u * s + v * r = mod throughout, so r, s <= mod while u, v >= 1
+	unsigned long long u = mod, v = a % m, r = 0, s = 1;
+	if (!v || mod == 1) {
+		return static_cast <A> (0);
+	}
+	unsigned int k = __builtin_ctzll(v);
+	v >>= k;
+	while (u != v) {
+		if (u > v) {
+			u -= v;
+			r += s;
+			const int t = __builtin_ctzll(u);
+			u >>= t;
+			s <<= t;
+			k += t;
+		} else {
+			v -= u;
+			s += r;
+			const int t = __builtin_ctzll(v);
+			v >>= t;
+			r <<= t;
+			k += t;
+		}
+	}
+	if (u != 1) {
+		return static_cast <A> (0);
+	}
+	r <<= 1;
+	k++;
+	r -= r >= mod ? mod : 0;
+	r -= r >= mod ? mod : 0;
+	unsigned long long x = r ? mod - r : 0;
+	// x * 2^-t = (x + q * mod) / 2^t with q = -x * mod^-1 mod 2^t
+	unsigned long long neg_inv = mod;
+	for (int i = 0; i < 6; i++) {
+		neg_inv *= 2 - mod * neg_inv;
+	}
+	neg_inv = -neg_inv;
+	while (k) {
+		const unsigned int t = std::min(k, 64U);
+		const unsigned long long q = x * neg_inv & (t < 64 ? (1ULL << t) - 1 : ~0ULL);
+		x = static_cast <unsigned long long> ((static_cast <unsigned __int128> (x) + static_cast <unsigned __int128> (q) * mod) >> t);
+		x -= x >= mod ? mod : 0;
+		k -= t;
+	}
+	return static_cast <A> (x);
+}
+
+// inv[i] = i^-1 mod m for 0 < i <= n in O(n) through inv[i] = -(m / i) * inv[m mod i], requires a prime m > n (inv[0] = 0)
+template <typename A> inline std::vector <A> inverse_table(size_t n, A m) {
+	std::vector <A> result(n + 1, static_cast <A> (0));
+	if (n >= 1) {
+		result[1] = static_cast <A> (1);
+	}
+	for (size_t i = 2; i <= n; i++) {
+		const A value = mul_mod(m / static_cast <A> (i), result[m % static_cast <A> (i)], m);
+		result[i] = value ? m - value : value;
+	}
+	return result;
+}
+
+// a[i]^-1 mod m for every i with a single call to inverse() (montgomery's trick), 0 stays 0, every other value must be invertible
+template <typename A> inline std::vector <A> inverse_batch(const A* a, size_t n, A m) {
+	auto reduce = [m] (A value) -> A {
+		value %= m;
+		if constexpr (static_cast <A> (-1) < static_cast <A> (0)) {
+			value += value < static_cast <A> (0) ? m : static_cast <A> (0);
+		}
+		return value;
+	};
+	std::vector <A> result(n);
+	A product = static_cast <A> (1) % m;
+	for (size_t i = 0; i < n; i++) {
+		result[i] = product;
+		if (const A value = reduce(a[i])) {
+			product = mul_mod(product, value, m);
+		}
+	}
+	A inv = inverse(product, m);
+	for (size_t i = n; i--; ) {
+		if (const A value = reduce(a[i])) {
+			result[i] = mul_mod(inv, result[i], m);
+			inv = mul_mod(inv, value, m);
+		} else {
+			result[i] = static_cast <A> (0);
+		}
+	}
+	return result;
+}
+
+// m is not deduced, so e.g. a vector of long long takes an int modulus
+template <typename A> inline std::vector <A> inverse_batch(const std::vector <A>& a, typename std::vector <A>::value_type m) {
+	return inverse_batch(a.data(), a.size(), m);
 }
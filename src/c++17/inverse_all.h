@@ -0,0 +1,98 @@
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
+
+// inverts n mod ints with a single call to inverse() and 3n multiplications (montgomery's trick)
+// works for any mod int type M, zeros stay zero, every other value must be invertible
+// with threads > 1 the array is split into chunks inverted in parallel, one inverse() per chunk
+// the workers of the parallel mode run under the calling thread's modulus when M keeps it thread local (Dmint, Dmint64)
+template <typename M> class Inverse_all {
+
+public:
+
+	static void inplace(M* a, size_t n, unsigned int threads = 1) {
+		threads = std::max(1U, std::min <unsigned int> (threads, n / m_min_chunk));
+		if (threads == 1) {
+			m_inplace(a, n);
+			return;
+		}
+		std::vector <std::thread> workers;
+		workers.reserve(threads - 1);
+		const size_t chunk = (n + threads - 1) / threads;
+		for (unsigned int t = 1; t < threads; t++) {
+			const size_t begin = std::min(n, chunk * t);
+			const size_t end = std::min(n, begin + chunk);
+			workers.push_back(m_spawn([a, begin, end] () -> void { m_inplace(a + begin, end - begin); }));
+		}
+		m_inplace(a, std::min(n, chunk));
+		for (std::thread& worker : workers) {
+			worker.join();
+		}
+	}
+
+private:
+
+	static constexpr const size_t m_min_chunk = 1 << 16;
+
+	template <typename B, typename = void> struct m_has_context : std::false_type { };
+	template <typename B> struct m_has_context <B, std::void_t <decltype(B::set_context(B::context()))>> : std::true_type { };
+
+	// a thread running f, under the modulus of the calling thread if M keeps it thread local
+	template <typename F> static std::thread m_spawn(F&& f) {
+		if constexpr (m_has_context <M>::value) {
+			return std::thread([f, context = M::context()] () -> void {
+				M::set_context(context);
+				f();
+			});
+		} else {
+			return std::thread(std::forward <F> (f));
+		}
+	}
+
+	static void m_inplace(M* a, size_t n) {
+		if (!n) {
+			return;
+		}
+		// prefix[i] is the product of the non zero values among a[0] ... a[i - 1]
+		std::vector <M> prefix(n);
+		M product = M(1);
+		for (size_t i = 0; i < n; i++) {
+			prefix[i] = product;
+			if (a[i] != M(0)) {
+				product *= a[i];
+			}
+		}
+		M inv = inverse(product);
+		for (size_t i = n; i--; ) {
+			if (a[i] != M(0)) {
+				const M value = a[i];
+				a[i] = inv * prefix[i];
+				inv *= value;
+			}
+		}
+	}
+
+};
+
+template <typename M> inline void inverse_all_inplace(M* a, size_t n, unsigned int threads = 1) {
+	Inverse_all <M>::inplace(a, n, threads);
+}
+
+template <typename M> inline void inverse_all_inplace(std::vector <M>& a, unsigned int threads = 1) {
+	Inverse_all <M>::inplace(a.data(), a.size(), threads);
+}
+
+template <typename M> inline std::vector <M> inverse_all(const M* a, size_t n, unsigned int threads = 1) {
+	std::vector <M> result(a, a + n);
+	Inverse_all <M>::inplace(result.data(), n, threads);
+	return result;
+}
+
+template <typename M> inline std::vector <M> inverse_all(std::vector <M> a, unsigned int threads = 1) {
+	Inverse_all <M>::inplace(a.data(), a.size(), threads);
+	return a;
+}
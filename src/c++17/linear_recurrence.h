@@ -0,0 +1,179 @@
+#pragma once
+
+#include "ntt.h"
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+// linear recurrences a[i] = c[0] * a[i - 1] + c[1] * a[i - 2] + ... + c[d - 1] * a[i - d] over a mod int type M
+// the n-th term is found with bostan-mori, repeatedly reducing [x^n] p / q to [x^(n / 2)] of a half size fraction
+// for Mint every step is a convolution (O(d log d log n)), with the NTT transforms of q shared between both products when possible
+// any other M (e.g. Dmint) falls back to naive products (O(d^2 log n))
+template <typename M> class Linear_recurrence {
+
+public:
+
+	// shortest c generating a[0 ... n) (see above), requires a prime modulus
+	static std::vector <M> berlekamp_massey(const M* a, size_t n) {
+		std::vector <M> c(n + 1), b(n + 1), t;
+		c[0] = b[0] = M(1);
+		M last = 1;
+		size_t len = 0, shift = 0;
+		for (size_t i = 0; i < n; i++) {
+			shift++;
+			M d = a[i];
+			for (size_t j = 1; j <= len; j++) {
+				d += c[j] * a[i - j];
+			}
+			if (d == M(0)) {
+				continue;
+			}
+			const M coef = d * inverse(last);
+			if (2 * len <= i) {
+				t = c;
+			}
+			for (size_t j = shift; j <= n; j++) {
+				c[j] -= coef * b[j - shift];
+			}
+			if (2 * len > i) {
+				continue;
+			}
+			len = i + 1 - len;
+			b.swap(t);
+			last = d;
+			shift = 0;
+		}
+		std::vector <M> result(len);
+		for (size_t i = 0; i < len; i++) {
+			result[i] = -c[i + 1];
+		}
+		return result;
+	}
+
+	// [x^n] p / q, requires q[0] to be invertible
+	static M bostan_mori(std::vector <M> p, std::vector <M> q, unsigned long long n) {
+		while (n && !p.empty()) {
+			m_step(p, q, n & 1);
+			n >>= 1;
+		}
+		return p.empty() ? M(0) : p[0] * inverse(q[0]);
+	}
+
+	// a[n] given the first d terms a[0 ... d) and the coefficients c[0 ... d)
+	static M nth_term(const M* a, const M* c, size_t d, unsigned long long n) {
+		if (n < d) {
+			return a[n];
+		}
+		if (!d) {
+			return M(0);
+		}
+		// q = 1 - c[0] x - ... - c[d - 1] x^d, p = (a * q) mod x^d
+		std::vector <M> q(d + 1);
+		q[0] = M(1);
+		for (size_t i = 0; i < d; i++) {
+			q[i + 1] = -c[i];
+		}
+		std::vector <M> p = m_multiply(std::vector <M> (a, a + d), q);
+		p.resize(d);
+		return bostan_mori(std::move(p), std::move(q), n);
+	}
+
+private:
+
+	static constexpr const size_t m_naive_threshold = 60;
+
+	template <typename A> static std::vector <A> m_multiply(const std::vector <A>& a, const std::vector <A>& b) {
+		if (a.empty() || b.empty()) {
+			return { };
+		}
+		std::vector <A> result(a.size() + b.size() - 1);
+		for (size_t i = 0; i < a.size(); i++) {
+			for (size_t j = 0; j < b.size(); j++) {
+				result[i + j] += a[i] * b[j];
+			}
+		}
+		return result;
+	}
+
+	template <int MOD, bool IS_PRIME> static std::vector <Mint <MOD, IS_PRIME>> m_multiply(const std::vector <Mint <MOD, IS_PRIME>>& a, const std::vector <Mint <MOD, IS_PRIME>>& b) {
+		return convolution(a, b);
+	}
+
+	// p / q <- even or odd part of p(x) q(-x) / q(x) q(-x), with x^2 replaced by x
+	template <typename A> static void m_step(std::vector <A>& p, std::vector <A>& q, bool odd) {
+		std::vector <A> qm = q;
+		for (size_t i = 1; i < qm.size(); i += 2) {
+			qm[i] = -qm[i];
+		}
+		const std::vector <A> pq = m_multiply(p, qm);
+		const std::vector <A> qq = m_multiply(q, qm);
+		p.assign((pq.size() + !odd) >> 1, A(0));
+		for (size_t i = 0; i < p.size(); i++) {
+			p[i] = pq[i << 1 | odd];
+		}
+		q.assign((qq.size() + 1) >> 1, A(0));
+		for (size_t i = 0; i < q.size(); i++) {
+			q[i] = qq[i << 1];
+		}
+	}
+
+	template <int MOD, bool IS_PRIME> static void m_step(std::vector <Mint <MOD, IS_PRIME>>& p, std::vector <Mint <MOD, IS_PRIME>>& q, bool odd) {
+		using mint = Mint <MOD, IS_PRIME>;
+		if constexpr (IS_PRIME) {
+			size_t z = 1;
+			while (z < p.size() + q.size() - 1 || z < (q.size() << 1) - 1) {
+				z <<= 1;
+			}
+			if (q.size() > m_naive_threshold && z <= (1ULL << Ntt <MOD, IS_PRIME>::rank)) {
+				// transform slots i and i ^ 1 hold the evaluations at w and -w, so q(-x) needs no transform of its own
+				std::vector <mint> fp(z), fq(z);
+				std::copy(p.begin(), p.end(), fp.begin());
+				std::copy(q.begin(), q.end(), fq.begin());
+				Ntt <MOD, IS_PRIME>::transform(fp.data(), z);
+				Ntt <MOD, IS_PRIME>::transform(fq.data(), z);
+				for (size_t i = 0; i < z; i += 2) {
+					fp[i] *= fq[i + 1];
+					fp[i + 1] *= fq[i];
+					fq[i] = fq[i + 1] = fq[i] * fq[i + 1];
+				}
+				Ntt <MOD, IS_PRIME>::inverse_transform(fp.data(), z);
+				Ntt <MOD, IS_PRIME>::inverse_transform(fq.data(), z);
+				const mint iz = inverse(mint(z));
+				const size_t pn = (p.size() + q.size() - 1 + !odd) >> 1, qn = q.size();
+				p.resize(pn);
+				for (size_t i = 0; i < pn; i++) {
+					p[i] = fp[i << 1 | odd] * iz;
+				}
+				for (size_t i = 0; i < qn; i++) {
+					q[i] = fq[i << 1] * iz;
+				}
+				return;
+			}
+		}
+		m_step <mint> (p, q, odd);
+	}
+
+};
+
+template <typename M> inline std::vector <M> berlekamp_massey(const std::vector <M>& a) {
+	return Linear_recurrence <M>::berlekamp_massey(a.data(), a.size());
+}
+
+template <typename M> inline M bostan_mori(std::vector <M> p, std::vector <M> q, unsigned long long n) {
+	return Linear_recurrence <M>::bostan_mori(std::move(p), std::move(q), n);
+}
+
+// requires a.size() >= c.size()
+template <typename M> inline M linear_recurrence_nth(const std::vector <M>& a, const std::vector <M>& c, unsigned long long n) {
+	return Linear_recurrence <M>::nth_term(a.data(), c.data(), c.size(), n);
+}
+
+// a[n] for the shortest recurrence generating the given prefix of a (which should hold at least twice its order terms)
+template <typename M> inline M guess_nth_term(const std::vector <M>& a, unsigned long long n) {
+	if (n < a.size()) {
+		return a[n];
+	}
+	const std::vector <M> c = berlekamp_massey(a);
+	return Linear_recurrence <M>::nth_term(a.data(), c.data(), c.size(), n);
+}
@@ -1,12 +1,14 @@
 #pragma once
 
 #include "phi.h"
+#include "factor_core.h"
 
 #include <limits>
 #include <iostream>
 #include <vector>
 
-template <int MOD, bool IS_PRIME = false> class Mint {
+// IS_PRIME defaults to a compile time miller-rabin test of MOD
+template <int MOD, bool IS_PRIME = Factor::is_prime(MOD)> class Mint {
 
 public:
 
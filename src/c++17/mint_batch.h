@@ -0,0 +1,263 @@
+#pragma once
+
+#include "mint.h"
+
+#include <cstddef>
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define MINT_BATCH_X86
+#endif
+
+// elementwise arithmetic over contiguous arrays of Mint
+// uses AVX2 with montgomery reduction when the cpu supports it (and MOD is odd), scalar code otherwise
+// the kernels are written with gcc vector extensions instead of intrinsics, so they need no header that prep would drop
+// the destination may alias any of the sources
+template <int MOD, bool IS_PRIME> class Mint_batch {
+
+	using mint = Mint <MOD, IS_PRIME>;
+	static_assert(sizeof(mint) == sizeof(int));
+
+public:
+
+	// dst[i] = a[i] + b[i]
+	static inline void add(mint* dst, const mint* a, const mint* b, size_t n) noexcept {
+		size_t i = 0;
+#ifdef MINT_BATCH_X86
+		if (m_use_avx2()) {
+			i = m_avx2_add(m_raw(dst), m_raw(a), m_raw(b), n);
+		}
+#endif
+		for (; i < n; i++) {
+			dst[i] = a[i] + b[i];
+		}
+	}
+
+	// dst[i] = a[i] - b[i]
+	static inline void sub(mint* dst, const mint* a, const mint* b, size_t n) noexcept {
+		size_t i = 0;
+#ifdef MINT_BATCH_X86
+		if (m_use_avx2()) {
+			i = m_avx2_sub(m_raw(dst), m_raw(a), m_raw(b), n);
+		}
+#endif
+		for (; i < n; i++) {
+			dst[i] = a[i] - b[i];
+		}
+	}
+
+	// dst[i] = a[i] * b[i]
+	static inline void mul(mint* dst, const mint* a, const mint* b, size_t n) noexcept {
+		size_t i = 0;
+#ifdef MINT_BATCH_X86
+		if (m_use_avx2()) {
+			i = m_avx2_mul(m_raw(dst), m_raw(a), m_raw(b), n);
+		}
+#endif
+		for (; i < n; i++) {
+			dst[i] = a[i] * b[i];
+		}
+	}
+
+	// dst[i] = a[i] * b[i] + c[i]
+	static inline void fma(mint* dst, const mint* a, const mint* b, const mint* c, size_t n) noexcept {
+		size_t i = 0;
+#ifdef MINT_BATCH_X86
+		if (m_use_avx2()) {
+			i = m_avx2_fma(m_raw(dst), m_raw(a), m_raw(b), m_raw(c), n);
+		}
+#endif
+		for (; i < n; i++) {
+			dst[i] = a[i] * b[i] + c[i];
+		}
+	}
+
+	// dst[i] = a[i] * c
+	static inline void scale(mint* dst, const mint* a, const mint& c, size_t n) noexcept {
+		size_t i = 0;
+#ifdef MINT_BATCH_X86
+		if (m_use_avx2()) {
+			i = m_avx2_scale(m_raw(dst), m_raw(a), static_cast <unsigned int> ((static_cast <unsigned long long> ((int) c) << 32) % MOD), n);
+		}
+#endif
+		for (; i < n; i++) {
+			dst[i] = a[i] * c;
+		}
+	}
+
+	// sum of a[i] * b[i]
+	static inline mint dot(const mint* a, const mint* b, size_t n) noexcept {
+		size_t i = 0;
+		mint result = 0;
+#ifdef MINT_BATCH_X86
+		if (m_use_avx2()) {
+			// the vector part accumulates a[i] * b[i] * 2^-32
+			result = mint(m_avx2_dot(m_raw(a), m_raw(b), n, i)) * mint((1ULL << 32) % MOD);
+		}
+#endif
+		for (; i < n; i++) {
+			result += a[i] * b[i];
+		}
+		return result;
+	}
+
+private:
+
+	static inline unsigned int* m_raw(mint* ptr) noexcept {
+		return reinterpret_cast <unsigned int*> (ptr);
+	}
+
+	static inline const unsigned int* m_raw(const mint* ptr) noexcept {
+		return reinterpret_cast <const unsigned int*> (ptr);
+	}
+
+#ifdef MINT_BATCH_X86
+
+	static inline bool m_use_avx2() noexcept {
+		if constexpr (!(MOD & 1) || MOD < 3) {
+			return false;
+		}
+		static const bool result = __builtin_cpu_supports("avx2");
+		return result;
+	}
+
+	// -MOD^-1 mod 2^32
+	static constexpr unsigned int m_np() noexcept {
+		unsigned int result = MOD;
+		for (int i = 0; i < 4; i++) {
+			result *= 2 - MOD * result;
+		}
+		return -result;
+	}
+
+	static constexpr unsigned int m_r2 = static_cast <unsigned int> ((static_cast <unsigned __int128> (1) << 64) % MOD);
+
+	// 8 lanes of 32 bits, viewed as 4 lanes of 64 bits for the widening products (m_i32x8 is what the gcc builtins take)
+	typedef unsigned int m_u32x8 __attribute__ ((vector_size(32)));
+	typedef unsigned long long m_u64x4 __attribute__ ((vector_size(32)));
+	typedef int m_i32x8 __attribute__ ((vector_size(32)));
+
+	__attribute__((target("avx2"))) static inline m_u32x8 m_min(m_u32x8 a, m_u32x8 b) noexcept {
+		return reinterpret_cast <m_u32x8> (__builtin_ia32_pminud256(reinterpret_cast <m_i32x8> (a), reinterpret_cast <m_i32x8> (b)));
+	}
+
+	// low 32 bits of each 64-bit lane of a times those of b, as 64-bit products (vpmuludq)
+	template <typename A, typename B> __attribute__((target("avx2"))) static inline m_u64x4 m_mul_even(A a, B b) noexcept {
+		return reinterpret_cast <m_u64x4> (__builtin_ia32_pmuludq256(reinterpret_cast <m_i32x8> (a), reinterpret_cast <m_i32x8> (b)));
+	}
+
+	// for each 32-bit lane: a * b * 2^-32 mod MOD
+	__attribute__((target("avx2"))) static inline m_u32x8 m_mont(m_u32x8 a, m_u32x8 b) noexcept {
+		const m_u32x8 p = m_u32x8 { } + static_cast <unsigned int> (MOD);
+		const m_u32x8 np = m_u32x8 { } + m_np();
+		const m_u64x4 t_even = m_mul_even(a, b);
+		const m_u64x4 t_odd = m_mul_even(reinterpret_cast <m_u64x4> (a) >> 32, reinterpret_cast <m_u64x4> (b) >> 32);
+		const m_u64x4 u_even = t_even + m_mul_even(m_mul_even(t_even, np), p);
+		const m_u64x4 u_odd = t_odd + m_mul_even(m_mul_even(t_odd, np), p);
+		const m_u32x8 u = reinterpret_cast <m_u32x8> ((u_even >> 32) | (u_odd & ~(m_u64x4 { } + 0xffffffffULL)));
+		return m_min(u, u - p);
+	}
+
+	__attribute__((target("avx2"))) static inline m_u32x8 m_add(m_u32x8 a, m_u32x8 b) noexcept {
+		const m_u32x8 sum = a + b;
+		return m_min(sum, sum - static_cast <unsigned int> (MOD));
+	}
+
+	__attribute__((target("avx2"))) static inline m_u32x8 m_sub(m_u32x8 a, m_u32x8 b) noexcept {
+		const m_u32x8 dif = a - b;
+		return m_min(dif, dif + static_cast <unsigned int> (MOD));
+	}
+
+	__attribute__((target("avx2"))) static inline m_u32x8 m_load(const unsigned int* ptr) noexcept {
+		m_u32x8 result;
+		__builtin_memcpy(&result, ptr, sizeof(result));
+		return result;
+	}
+
+	__attribute__((target("avx2"))) static inline void m_store(unsigned int* ptr, m_u32x8 value) noexcept {
+		__builtin_memcpy(ptr, &value, sizeof(value));
+	}
+
+	// the kernels below return the number of elements processed
+
+	__attribute__((target("avx2"))) static size_t m_avx2_add(unsigned int* dst, const unsigned int* a, const unsigned int* b, size_t n) noexcept {
+		size_t i = 0;
+		for (; i + 8 <= n; i += 8) {
+			m_store(dst + i, m_add(m_load(a + i), m_load(b + i)));
+		}
+		return i;
+	}
+
+	__attribute__((target("avx2"))) static size_t m_avx2_sub(unsigned int* dst, const unsigned int* a, const unsigned int* b, size_t n) noexcept {
+		size_t i = 0;
+		for (; i + 8 <= n; i += 8) {
+			m_store(dst + i, m_sub(m_load(a + i), m_load(b + i)));
+		}
+		return i;
+	}
+
+	__attribute__((target("avx2"))) static size_t m_avx2_mul(unsigned int* dst, const unsigned int* a, const unsigned int* b, size_t n) noexcept {
+		const m_u32x8 r2 = m_u32x8 { } + m_r2;
+		size_t i = 0;
+		for (; i + 8 <= n; i += 8) {
+			m_store(dst + i, m_mont(m_mont(m_load(a + i), m_load(b + i)), r2));
+		}
+		return i;
+	}
+
+	__attribute__((target("avx2"))) static size_t m_avx2_fma(unsigned int* dst, const unsigned int* a, const unsigned int* b, const unsigned int* c, size_t n) noexcept {
+		const m_u32x8 r2 = m_u32x8 { } + m_r2;
+		size_t i = 0;
+		for (; i + 8 <= n; i += 8) {
+			m_store(dst + i, m_add(m_mont(m_mont(m_load(a + i), m_load(b + i)), r2), m_load(c + i)));
+		}
+		return i;
+	}
+
+	// c_mont is c * 2^32 mod MOD
+	__attribute__((target("avx2"))) static size_t m_avx2_scale(unsigned int* dst, const unsigned int* a, unsigned int c_mont, size_t n) noexcept {
+		const m_u32x8 c = m_u32x8 { } + c_mont;
+		size_t i = 0;
+		for (; i + 8 <= n; i += 8) {
+			m_store(dst + i, m_mont(m_load(a + i), c));
+		}
+		return i;
+	}
+
+	__attribute__((target("avx2"))) static unsigned int m_avx2_dot(const unsigned int* a, const unsigned int* b, size_t n, size_t& i) noexcept {
+		m_u32x8 acc = { };
+		for (; i + 8 <= n; i += 8) {
+			acc = m_add(acc, m_mont(m_load(a + i), m_load(b + i)));
+		}
+		unsigned long long result = 0;
+		for (int j = 0; j < 8; j++) {
+			result += acc[j];
+		}
+		return result % MOD;
+	}
+
+#endif
+
+};
+
+template <int MOD, bool IS_PRIME> inline void batch_add(Mint <MOD, IS_PRIME>* dst, const Mint <MOD, IS_PRIME>* a, const Mint <MOD, IS_PRIME>* b, size_t n) noexcept {
+	Mint_batch <MOD, IS_PRIME>::add(dst, a, b, n);
+}
+
+template <int MOD, bool IS_PRIME> inline void batch_sub(Mint <MOD, IS_PRIME>* dst, const Mint <MOD, IS_PRIME>* a, const Mint <MOD, IS_PRIME>* b, size_t n) noexcept {
+	Mint_batch <MOD, IS_PRIME>::sub(dst, a, b, n);
+}
+
+template <int MOD, bool IS_PRIME> inline void batch_mul(Mint <MOD, IS_PRIME>* dst, const Mint <MOD, IS_PRIME>* a, const Mint <MOD, IS_PRIME>* b, size_t n) noexcept {
+	Mint_batch <MOD, IS_PRIME>::mul(dst, a, b, n);
+}
+
+template <int MOD, bool IS_PRIME> inline void batch_fma(Mint <MOD, IS_PRIME>* dst, const Mint <MOD, IS_PRIME>* a, const Mint <MOD, IS_PRIME>* b, const Mint <MOD, IS_PRIME>* c, size_t n) noexcept {
+	Mint_batch <MOD, IS_PRIME>::fma(dst, a, b, c, n);
+}
+
+template <int MOD, bool IS_PRIME> inline void batch_scale(Mint <MOD, IS_PRIME>* dst, const Mint <MOD, IS_PRIME>* a, const Mint <MOD, IS_PRIME>& c, size_t n) noexcept {
+	Mint_batch <MOD, IS_PRIME>::scale(dst, a, c, n);
+}
+
+template <int MOD, bool IS_PRIME> inline Mint <MOD, IS_PRIME> batch_dot(const Mint <MOD, IS_PRIME>* a, const Mint <MOD, IS_PRIME>* b, size_t n) noexcept {
+	return Mint_batch <MOD, IS_PRIME>::dot(a, b, n);
+}
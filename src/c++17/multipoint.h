@@ -0,0 +1,150 @@
+#pragma once
+
+#include "fps.h"
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+// subproduct tree over the points x[0 ... n) for an NTT friendly Mint
+// node v covers [l, r) and holds prod (x - x[i]) for l <= i < r as r - l + 1 coefficients, children are 2v and 2v + 1
+// every node polynomial lives in one contiguous arena (O(n log n) values), indexed through a per node offset
+// evaluate() and interpolate() both run in O(n log^2 n)
+template <typename M> class Multipoint {
+
+public:
+
+	Multipoint(const M* x, size_t n) :
+	m_x(x, x + n),
+	m_arena(),
+	m_offset(n ? n << 2 : 0)
+	{
+		if (n) {
+			this->m_arena.resize(this->m_place(1, 0, n, 0));
+			this->m_build(1, 0, n);
+		}
+	}
+
+	Multipoint(const std::vector <M>& x) : Multipoint(x.data(), x.size()) { }
+
+	size_t size() const noexcept {
+		return this->m_x.size();
+	}
+
+	// prod (x - x[i])
+	Fps <M> product() const {
+		if (this->m_x.empty()) {
+			return Fps <M> { M(1) };
+		}
+		return Fps <M> (this->m_poly(1), this->m_poly(1) + this->m_x.size() + 1);
+	}
+
+	// f(x[i]) for every point
+	std::vector <M> evaluate(const Fps <M>& f) const {
+		std::vector <M> result(this->m_x.size());
+		if (!this->m_x.empty()) {
+			this->m_evaluate(1, 0, this->m_x.size(), f.size() > this->m_x.size() ? f % this->product() : f, result);
+		}
+		return result;
+	}
+
+	// the unique polynomial of degree < n through (x[i], y[i]), requires distinct points
+	Fps <M> interpolate(const M* y) const {
+		if (this->m_x.empty()) {
+			return { };
+		}
+		// lagrange weights y[i] / prod_{j != i} (x[i] - x[j]), the denominator being product()'(x[i])
+		std::vector <M> w = this->evaluate(this->product().derivative());
+		for (size_t i = 0; i < w.size(); i++) {
+			w[i] = y[i] * inverse(w[i]);
+		}
+		Fps <M> result = this->m_combine(1, 0, this->m_x.size(), w);
+		result.resize(this->m_x.size());
+		return result;
+	}
+
+	Fps <M> interpolate(const std::vector <M>& y) const {
+		return this->interpolate(y.data());
+	}
+
+private:
+
+	std::vector <M> m_x;
+	std::vector <M> m_arena;
+	std::vector <size_t> m_offset;
+
+	// below this many points remainders are evaluated directly with horner's rule
+	static constexpr const size_t m_leaf = 64;
+
+	const M* m_poly(size_t v) const noexcept {
+		return this->m_arena.data() + this->m_offset[v];
+	}
+
+	// assigns arena offsets in pre order, returns the end of the subtree's range
+	size_t m_place(size_t v, size_t l, size_t r, size_t offset) noexcept {
+		this->m_offset[v] = offset;
+		offset += r - l + 1;
+		if (r - l > 1) {
+			const size_t mid = (l + r) >> 1;
+			offset = this->m_place(v << 1, l, mid, offset);
+			offset = this->m_place(v << 1 | 1, mid, r, offset);
+		}
+		return offset;
+	}
+
+	void m_build(size_t v, size_t l, size_t r) {
+		M* poly = this->m_arena.data() + this->m_offset[v];
+		if (r - l == 1) {
+			poly[0] = -this->m_x[l];
+			poly[1] = M(1);
+			return;
+		}
+		const size_t mid = (l + r) >> 1;
+		this->m_build(v << 1, l, mid);
+		this->m_build(v << 1 | 1, mid, r);
+		const std::vector <M> product = convolution(this->m_poly(v << 1), mid - l + 1, this->m_poly(v << 1 | 1), r - mid + 1);
+		std::copy(product.begin(), product.end(), poly);
+	}
+
+	// f has already been reduced modulo the product of node v
+	void m_evaluate(size_t v, size_t l, size_t r, const Fps <M>& f, std::vector <M>& result) const {
+		if (r - l <= m_leaf) {
+			for (size_t i = l; i < r; i++) {
+				result[i] = f(this->m_x[i]);
+			}
+			return;
+		}
+		const size_t mid = (l + r) >> 1;
+		const Fps <M> left(this->m_poly(v << 1), this->m_poly(v << 1) + mid - l + 1);
+		const Fps <M> right(this->m_poly(v << 1 | 1), this->m_poly(v << 1 | 1) + r - mid + 1);
+		this->m_evaluate(v << 1, l, mid, f % left, result);
+		this->m_evaluate(v << 1 | 1, mid, r, f % right, result);
+	}
+
+	// sum of w[i] * prod_{j != i} (x - x[j]) over l <= i < r
+	Fps <M> m_combine(size_t v, size_t l, size_t r, const std::vector <M>& w) const {
+		if (r - l == 1) {
+			return Fps <M> { w[l] };
+		}
+		const size_t mid = (l + r) >> 1;
+		const Fps <M> left = this->m_combine(v << 1, l, mid, w);
+		const Fps <M> right = this->m_combine(v << 1 | 1, mid, r, w);
+		Fps <M> result = convolution(left.data(), left.size(), this->m_poly(v << 1 | 1), r - mid + 1);
+		const std::vector <M> other = convolution(right.data(), right.size(), this->m_poly(v << 1), mid - l + 1);
+		result.resize(std::max(result.size(), other.size()));
+		for (size_t i = 0; i < other.size(); i++) {
+			result[i] += other[i];
+		}
+		return result;
+	}
+
+};
+
+template <typename M> inline std::vector <M> multipoint_evaluate(const Fps <M>& f, const std::vector <M>& x) {
+	return Multipoint <M> (x).evaluate(f);
+}
+
+// requires x.size() == y.size() and distinct x
+template <typename M> inline Fps <M> interpolate(const std::vector <M>& x, const std::vector <M>& y) {
+	return Multipoint <M> (x).interpolate(y);
+}
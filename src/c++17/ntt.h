@@ -0,0 +1,385 @@
+#pragma once
+
+#include "mint.h"
+
+#include <array>
+#include <vector>
+#include <algorithm>
+#ifdef _GLIBCXX_DEBUG
+#include <cassert>
+#endif
+
+// number theoretic transform over Mint <MOD, IS_PRIME>, MOD must be a prime of the form c * 2^k + 1
+// the transforms are iterative radix-4 (with one radix-2 layer for odd logarithms) on arrays of power of two length
+// all roots of unity are computed at compile time
+template <int MOD, bool IS_PRIME> class Ntt {
+
+	using mint = Mint <MOD, IS_PRIME>;
+
+public:
+
+	// largest supported transform length is 2^rank
+	static constexpr const int rank = __builtin_ctz(MOD - 1);
+
+	// a[i] becomes the evaluation at the bit reversed i-th root of unity
+	static void transform(mint* a, size_t n) noexcept {
+#ifdef _GLIBCXX_DEBUG
+		assert(!(n & (n - 1)) && n <= (1ULL << rank));
+#endif
+		const int h = __builtin_ctzll(n);
+		int len = 0;
+		while (len < h) {
+			if (h - len == 1) {
+				const size_t p = static_cast <size_t> (1) << (h - len - 1);
+				mint rot = 1;
+				for (size_t s = 0; s < (static_cast <size_t> (1) << len); s++) {
+					mint* block = a + (s << (h - len));
+					for (size_t i = 0; i < p; i++) {
+						const mint l = block[i];
+						const mint r = block[i + p] * rot;
+						block[i] = l + r;
+						block[i + p] = l - r;
+					}
+					if (s + 1 != (static_cast <size_t> (1) << len)) {
+						rot *= m_tables.rate2[__builtin_ctzll(~s)];
+					}
+				}
+				len++;
+			} else {
+				const size_t p = static_cast <size_t> (1) << (h - len - 2);
+				const mint imag = m_tables.root[2];
+				mint rot = 1;
+				for (size_t s = 0; s < (static_cast <size_t> (1) << len); s++) {
+					const mint rot2 = rot * rot;
+					const mint rot3 = rot2 * rot;
+					mint* block = a + (s << (h - len));
+					for (size_t i = 0; i < p; i++) {
+						const mint a0 = block[i];
+						const mint a1 = block[i + p] * rot;
+						const mint a2 = block[i + 2 * p] * rot2;
+						const mint a3 = block[i + 3 * p] * rot3;
+						const mint a1na3imag = (a1 - a3) * imag;
+						block[i] = a0 + a2 + (a1 + a3);
+						block[i + p] = a0 + a2 - (a1 + a3);
+						block[i + 2 * p] = a0 - a2 + a1na3imag;
+						block[i + 3 * p] = a0 - a2 - a1na3imag;
+					}
+					if (s + 1 != (static_cast <size_t> (1) << len)) {
+						rot *= m_tables.rate3[__builtin_ctzll(~s)];
+					}
+				}
+				len += 2;
+			}
+		}
+	}
+
+	// inverse of transform() without the division by n
+	static void inverse_transform(mint* a, size_t n) noexcept {
+#ifdef _GLIBCXX_DEBUG
+		assert(!(n & (n - 1)) && n <= (1ULL << rank));
+#endif
+		const int h = __builtin_ctzll(n);
+		int len = h;
+		while (len) {
+			if (len == 1) {
+				const size_t p = static_cast <size_t> (1) << (h - 1);
+				mint irot = 1;
+				for (size_t s = 0; s < (static_cast <size_t> (1) << (len - 1)); s++) {
+					mint* block = a + (s << (h - len + 1));
+					for (size_t i = 0; i < p; i++) {
+						const mint l = block[i];
+						const mint r = block[i + p];
+						block[i] = l + r;
+						block[i + p] = (l - r) * irot;
+					}
+					if (s + 1 != (static_cast <size_t> (1) << (len - 1))) {
+						irot *= m_tables.irate2[__builtin_ctzll(~s)];
+					}
+				}
+				len--;
+			} else {
+				const size_t p = static_cast <size_t> (1) << (h - len);
+				const mint iimag = m_tables.iroot[2];
+				mint irot = 1;
+				for (size_t s = 0; s < (static_cast <size_t> (1) << (len - 2)); s++) {
+					const mint irot2 = irot * irot;
+					const mint irot3 = irot2 * irot;
+					mint* block = a + (s << (h - len + 2));
+					for (size_t i = 0; i < p; i++) {
+						const mint a0 = block[i];
+						const mint a1 = block[i + p];
+						const mint a2 = block[i + 2 * p];
+						const mint a3 = block[i + 3 * p];
+						const mint a2na3iimag = (a2 - a3) * iimag;
+						block[i] = a0 + a1 + (a2 + a3);
+						block[i + p] = (a0 - a1 + a2na3iimag) * irot;
+						block[i + 2 * p] = (a0 + a1 - (a2 + a3)) * irot2;
+						block[i + 3 * p] = (a0 - a1 - a2na3iimag) * irot3;
+					}
+					if (s + 1 != (static_cast <size_t> (1) << (len - 2))) {
+						irot *= m_tables.irate3[__builtin_ctzll(~s)];
+					}
+				}
+				len -= 2;
+			}
+		}
+	}
+
+	static std::vector <mint> convolution(const mint* a, size_t n, const mint* b, size_t m) {
+		if (!n || !m) {
+			return { };
+		}
+		if (std::min(n, m) <= m_naive_threshold) {
+			return m_naive(a, n, b, m);
+		}
+		size_t z = 1;
+		while (z < n + m - 1) {
+			z <<= 1;
+		}
+		std::vector <mint> fa(z), fb;
+		std::copy(a, a + n, fa.begin());
+		transform(fa.data(), z);
+		if (a == b && n == m) {
+			for (size_t i = 0; i < z; i++) {
+				fa[i] *= fa[i];
+			}
+		} else {
+			fb.resize(z);
+			std::copy(b, b + m, fb.begin());
+			transform(fb.data(), z);
+			for (size_t i = 0; i < z; i++) {
+				fa[i] *= fb[i];
+			}
+		}
+		inverse_transform(fa.data(), z);
+		fa.resize(n + m - 1);
+		const mint iz = inverse(mint(z));
+		for (mint& x : fa) {
+			x *= iz;
+		}
+		return fa;
+	}
+
+private:
+
+	static constexpr const size_t m_naive_threshold = 60;
+
+	struct Tables {
+		// root[i]^(2^i) = 1, iroot[i] = root[i]^-1
+		std::array <mint, rank + 1> root;
+		std::array <mint, rank + 1> iroot;
+		// rate2[i] = root[i + 2] * iroot[2] * ... * iroot[i + 1], twiddle step between consecutive radix-2 blocks
+		std::array <mint, std::max(0, rank - 1)> rate2;
+		std::array <mint, std::max(0, rank - 1)> irate2;
+		// rate3[i] = root[i + 3] * iroot[3] * ... * iroot[i + 2], twiddle step between consecutive radix-4 blocks
+		std::array <mint, std::max(0, rank - 2)> rate3;
+		std::array <mint, std::max(0, rank - 2)> irate3;
+	};
+
+	static constexpr int m_primitive_root() noexcept {
+		int divisors[32] = { };
+		int cnt = 0;
+		int x = (MOD - 1) >> rank;
+		divisors[cnt++] = 2;
+		for (int i = 3; i * i <= x; i += 2) {
+			if (!(x % i)) {
+				divisors[cnt++] = i;
+				while (!(x % i)) {
+					x /= i;
+				}
+			}
+		}
+		if (x > 1) {
+			divisors[cnt++] = x;
+		}
+		for (int g = 2; ; g++) {
+			bool ok = true;
+			for (int i = 0; i < cnt && ok; i++) {
+				ok = mint::pow(mint(g), (MOD - 1) / divisors[i]) != mint(1);
+			}
+			if (ok) {
+				return g;
+			}
+		}
+	}
+
+	static constexpr Tables m_build() noexcept {
+		Tables result = { };
+		result.root[rank] = mint::pow(mint(m_primitive_root()), (MOD - 1) >> rank);
+		result.iroot[rank] = inverse(result.root[rank]);
+		for (int i = rank - 1; i >= 0; i--) {
+			result.root[i] = result.root[i + 1] * result.root[i + 1];
+			result.iroot[i] = result.iroot[i + 1] * result.iroot[i + 1];
+		}
+		mint prod = 1, iprod = 1;
+		for (int i = 0; i <= rank - 2; i++) {
+			result.rate2[i] = result.root[i + 2] * prod;
+			result.irate2[i] = result.iroot[i + 2] * iprod;
+			prod *= result.iroot[i + 2];
+			iprod *= result.root[i + 2];
+		}
+		prod = 1, iprod = 1;
+		for (int i = 0; i <= rank - 3; i++) {
+			result.rate3[i] = result.root[i + 3] * prod;
+			result.irate3[i] = result.iroot[i + 3] * iprod;
+			prod *= result.iroot[i + 3];
+			iprod *= result.root[i + 3];
+		}
+		return result;
+	}
+
+	static constexpr const Tables m_tables = m_build();
+
+	static std::vector <mint> m_naive(const mint* a, size_t n, const mint* b, size_t m) {
+		if (n < m) {
+			std::swap(a, b);
+			std::swap(n, m);
+		}
+		std::vector <mint> result(n + m - 1);
+		for (size_t i = 0; i < n; i++) {
+			for (size_t j = 0; j < m; j++) {
+				result[i + j] += a[i] * b[j];
+			}
+		}
+		return result;
+	}
+
+};
+
+// in place transform, a.size() must be a power of two
+template <int MOD, bool IS_PRIME> inline void ntt(std::vector <Mint <MOD, IS_PRIME>>& a) noexcept {
+	Ntt <MOD, IS_PRIME>::transform(a.data(), a.size());
+}
+
+// in place inverse transform (including the division by a.size()), a.size() must be a power of two
+template <int MOD, bool IS_PRIME> inline void intt(std::vector <Mint <MOD, IS_PRIME>>& a) noexcept {
+	Ntt <MOD, IS_PRIME>::inverse_transform(a.data(), a.size());
+	const Mint <MOD, IS_PRIME> in = inverse(Mint <MOD, IS_PRIME> (a.size()));
+	for (Mint <MOD, IS_PRIME>& x : a) {
+		x *= in;
+	}
+}
+
+// convolution under any modulus below 2^31 by convolving over three NTT primes and recombining with garner's algorithm
+// works for any mod int type M with M::mod() and a conversion to int, exact as long as min(n, m) * (M::mod() - 1)^2 < P0 * P1 * P2 (~2^85.6)
+// one transform holds at most 2^24 (the largest power of two dividing P0 - 1) coefficients, longer products are assembled
+// from blocks of 2^23 coefficients of each input, which also keeps every block within the bound above
+template <typename M> class Ntt_any {
+
+	static constexpr const int P0 = 754974721;
+	static constexpr const int P1 = 167772161;
+	static constexpr const int P2 = 469762049;
+
+public:
+
+	static std::vector <M> convolution(const M* a, size_t n, const M* b, size_t m) {
+		if (!n || !m) {
+			return { };
+		}
+		if (std::min(n, m) <= m_naive_threshold) {
+			return m_naive(a, n, b, m);
+		}
+		if (n + m - 1 > m_max_length) {
+			return m_blocked(a, n, b, m);
+		}
+		size_t z = 1;
+		while (z < n + m - 1) {
+			z <<= 1;
+		}
+		// every prime transforms both inputs back to back while its twiddle tables are hot
+		const std::vector <Mint <P0, true>> c0 = m_convolve_residues <P0> (a, n, b, m, z);
+		const std::vector <Mint <P1, true>> c1 = m_convolve_residues <P1> (a, n, b, m, z);
+		const std::vector <Mint <P2, true>> c2 = m_convolve_residues <P2> (a, n, b, m, z);
+		constexpr const Mint <P1, true> i0_1 = inverse(Mint <P1, true> (P0));
+		constexpr const Mint <P2, true> i0_2 = inverse(Mint <P2, true> (P0));
+		constexpr const Mint <P2, true> i1_2 = inverse(Mint <P2, true> (P1));
+		const M p0 = M(P0);
+		const M p0p1 = p0 * M(P1);
+		std::vector <M> result(n + m - 1);
+		for (size_t i = 0; i < result.size(); i++) {
+			const int x0 = (int) c0[i];
+			const int x1 = (int) ((c1[i] - Mint <P1, true> (x0)) * i0_1);
+			const int x2 = (int) (((c2[i] - Mint <P2, true> (x0)) * i0_2 - Mint <P2, true> (x1)) * i1_2);
+			result[i] = M(x0) + M(x1) * p0 + M(x2) * p0p1;
+		}
+		return result;
+	}
+
+private:
+
+	static constexpr const size_t m_naive_threshold = 60;
+	static constexpr const size_t m_max_length = static_cast <size_t> (1) << std::min({ Ntt <P0, true>::rank, Ntt <P1, true>::rank, Ntt <P2, true>::rank });
+
+	static std::vector <M> m_blocked(const M* a, size_t n, const M* b, size_t m) {
+		const size_t block = m_max_length >> 1;
+		std::vector <M> result(n + m - 1);
+		for (size_t i = 0; i < n; i += block) {
+			for (size_t j = 0; j < m; j += block) {
+				const std::vector <M> part = convolution(a + i, std::min(block, n - i), b + j, std::min(block, m - j));
+				for (size_t k = 0; k < part.size(); k++) {
+					result[i + j + k] += part[k];
+				}
+			}
+		}
+		return result;
+	}
+
+	template <int P> static std::vector <Mint <P, true>> m_convolve_residues(const M* a, size_t n, const M* b, size_t m, size_t z) {
+		std::vector <Mint <P, true>> fa(z), fb(z);
+		for (size_t i = 0; i < n; i++) {
+			fa[i] = Mint <P, true> ((int) a[i]);
+		}
+		for (size_t i = 0; i < m; i++) {
+			fb[i] = Mint <P, true> ((int) b[i]);
+		}
+		Ntt <P, true>::transform(fa.data(), z);
+		Ntt <P, true>::transform(fb.data(), z);
+		for (size_t i = 0; i < z; i++) {
+			fa[i] *= fb[i];
+		}
+		Ntt <P, true>::inverse_transform(fa.data(), z);
+		fa.resize(n + m - 1);
+		const Mint <P, true> iz = inverse(Mint <P, true> (z));
+		for (Mint <P, true>& x : fa) {
+			x *= iz;
+		}
+		return fa;
+	}
+
+	static std::vector <M> m_naive(const M* a, size_t n, const M* b, size_t m) {
+		if (n < m) {
+			std::swap(a, b);
+			std::swap(n, m);
+		}
+		std::vector <M> result(n + m - 1);
+		for (size_t i = 0; i < n; i++) {
+			for (size_t j = 0; j < m; j++) {
+				result[i + j] += a[i] * b[j];
+			}
+		}
+		return result;
+	}
+
+};
+
+template <typename M> inline std::vector <M> convolution_any(const M* a, size_t n, const M* b, size_t m) {
+	return Ntt_any <M>::convolution(a, n, b, m);
+}
+
+template <typename M> inline std::vector <M> convolution_any(const std::vector <M>& a, const std::vector <M>& b) {
+	return convolution_any(a.data(), a.size(), b.data(), b.size());
+}
+
+// uses a single NTT when MOD is a prime with a large enough power of two dividing MOD - 1, three NTT primes otherwise
+template <int MOD, bool IS_PRIME> inline std::vector <Mint <MOD, IS_PRIME>> convolution(const Mint <MOD, IS_PRIME>* a, size_t n, const Mint <MOD, IS_PRIME>* b, size_t m) {
+	if constexpr (IS_PRIME) {
+		if (n && m && n + m - 1 <= (1ULL << Ntt <MOD, IS_PRIME>::rank)) {
+			return Ntt <MOD, IS_PRIME>::convolution(a, n, b, m);
+		}
+	}
+	return Ntt_any <Mint <MOD, IS_PRIME>>::convolution(a, n, b, m);
+}
+
+template <int MOD, bool IS_PRIME> inline std::vector <Mint <MOD, IS_PRIME>> convolution(const std::vector <Mint <MOD, IS_PRIME>>& a, const std::vector <Mint <MOD, IS_PRIME>>& b) {
+	return convolution(a.data(), a.size(), b.data(), b.size());
+}
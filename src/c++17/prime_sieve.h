@@ -0,0 +1,197 @@
+#pragma once
+
+#include <vector>
+#include <cmath>
+#include <atomic>
+#include <thread>
+#include <iterator>
+#include <algorithm>
+
+// segmented sieve of eratosthenes over [lo, hi), requires hi < 2^63
+// only odd numbers are stored, one bit each, and every segment is m_bytes large so it stays in L1
+// multiples of 3, 5, 7, 11 and 13 are copied in from a periodic pattern instead of crossed off
+// every other prime p <= sqrt(hi) remembers its next odd multiple, so a segment costs no divisions
+// for_each() streams the primes in increasing order, count() only popcounts and can split the range over threads
+class Prime_sieve {
+
+	using value_type = unsigned long long;
+
+public:
+
+	// calls f(p) for every prime lo <= p < hi, in increasing order
+	template <typename F> static void for_each(value_type lo, value_type hi, F&& f) {
+		if (lo <= 2 && 2 < hi) {
+			f(static_cast <value_type> (2));
+		}
+		lo = std::max(lo, 3ULL) | 1;
+		if (lo >= hi) {
+			return;
+		}
+		const std::vector <unsigned int> base = m_base_primes(hi);
+		m_sieve(lo, hi, base, [&f] (value_type first, const value_type* words, size_t bits) -> void {
+			for (size_t i = 0; i < (bits + 63) >> 6; i++) {
+				for (value_type word = ~words[i]; word; word &= word - 1) {
+					f(first + ((i << 6 | __builtin_ctzll(word)) << 1));
+				}
+			}
+		});
+	}
+
+	// number of primes lo <= p < hi, batches of m_batch segments are handed out to the threads as they finish
+	static value_type count(value_type lo, value_type hi, unsigned int threads = 1) {
+		value_type result = lo <= 2 && 2 < hi;
+		lo = std::max(lo, 3ULL) | 1;
+		if (lo >= hi) {
+			return result;
+		}
+		const std::vector <unsigned int> base = m_base_primes(hi);
+		const value_type span = m_bits * m_batch << 1;
+		const value_type batches = (hi - lo + span - 1) / span;
+		threads = std::max(1U, static_cast <unsigned int> (std::min <value_type> (threads, batches)));
+		std::atomic <value_type> next_batch = 0;
+		std::vector <value_type> counts(threads, 0);
+		auto work = [&] (unsigned int t) -> void {
+			for (value_type batch = next_batch++; batch < batches; batch = next_batch++) {
+				const value_type first = lo + batch * span;
+				m_sieve(first, std::min(hi, first + span), base, [&counts, t] (value_type, const value_type* words, size_t bits) -> void {
+					for (size_t i = 0; i < (bits + 63) >> 6; i++) {
+						counts[t] += __builtin_popcountll(~words[i]);
+					}
+				});
+			}
+		};
+		std::vector <std::thread> workers;
+		workers.reserve(threads - 1);
+		for (unsigned int t = 1; t < threads; t++) {
+			workers.emplace_back(work, t);
+		}
+		work(0);
+		for (std::thread& worker : workers) {
+			worker.join();
+		}
+		for (const value_type c : counts) {
+			result += c;
+		}
+		return result;
+	}
+
+	static std::vector <value_type> primes(value_type lo, value_type hi) {
+		std::vector <value_type> result;
+		for_each(lo, hi, [&result] (value_type p) -> void { result.push_back(p); });
+		return result;
+	}
+
+private:
+
+	static constexpr const size_t m_bytes = 1 << 15;
+	// odd numbers covered by one segment
+	static constexpr const size_t m_bits = m_bytes << 3;
+	static constexpr const value_type m_batch = 64;
+
+	static constexpr const unsigned int m_presieved[] = { 3, 5, 7, 11, 13 };
+	// 3 * 5 * 7 * 11 * 13, the pattern spans m_period words so it repeats at word granularity
+	static constexpr const value_type m_period = 15015;
+	// 64^-1 mod m_period
+	static constexpr const value_type m_period_inv64 = 9619;
+
+	// bit i set iff 2i + 1 has a factor in m_presieved
+	static const std::vector <value_type>& m_pattern() {
+		static const std::vector <value_type> pattern = [] () -> std::vector <value_type> {
+			std::vector <value_type> result(m_period, 0);
+			for (value_type i = 0; i < m_period << 6; i++) {
+				for (const unsigned int p : m_presieved) {
+					if (!((i << 1 | 1) % p)) {
+						result[i >> 6] |= 1ULL << (i & 63);
+						break;
+					}
+				}
+			}
+			return result;
+		} ();
+		return pattern;
+	}
+
+	// odd primes p with p * p < hi
+	static std::vector <unsigned int> m_base_primes(value_type hi) {
+		value_type root = std::sqrt(static_cast <double> (hi));
+		while (root * root >= hi) {
+			root--;
+		}
+		while ((root + 1) * (root + 1) < hi) {
+			root++;
+		}
+		// composite[i] marks 2i + 1
+		std::vector <bool> composite((root + 1) >> 1, false);
+		std::vector <unsigned int> result;
+		for (value_type i = 1; i < composite.size(); i++) {
+			if (composite[i]) {
+				continue;
+			}
+			const value_type p = i << 1 | 1;
+			result.push_back(static_cast <unsigned int> (p));
+			for (value_type j = (p * p) >> 1; j < composite.size(); j += p) {
+				composite[j] = true;
+			}
+		}
+		return result;
+	}
+
+	// sieves the odd numbers of [lo, hi) segment by segment (lo odd)
+	// f(first, words, bits) sees bit i of words set iff first + 2i is not prime, bits past the end of [lo, hi) are set
+	template <typename F> static void m_sieve(value_type lo, value_type hi, const std::vector <unsigned int>& base, F&& f) {
+		const std::vector <value_type>& pattern = m_pattern();
+		std::vector <value_type> words(m_bits >> 6);
+		size_t skip = 0;
+		while (skip < base.size() && base[skip] <= m_presieved[std::size(m_presieved) - 1]) {
+			skip++;
+		}
+		// next[k] is the index (counted in odd numbers from lo) of the next odd multiple of base[k] to cross off
+		std::vector <value_type> next(base.size());
+		for (size_t k = skip; k < base.size(); k++) {
+			const value_type p = base[k];
+			value_type start = (lo + p - 1) / p * p;
+			start += start & 1 ? 0 : p;
+			next[k] = (std::max(start, p * p) - lo) >> 1;
+		}
+		for (value_type first = lo, offset = 0; first < hi; first += m_bits << 1, offset += m_bits) {
+			const size_t bits = std::min <value_type> (m_bits, (hi - first + 1) >> 1);
+			const value_type last = first + ((bits - 1) << 1), end = offset + bits;
+			// bit 0 of the segment sits at position (first - 1) / 2 of the pattern, word t of the pattern starts there
+			value_type t = ((first - 1) >> 1) % m_period * m_period_inv64 % m_period;
+			for (size_t w = 0; w < (bits + 63) >> 6; w++) {
+				words[w] = pattern[t];
+				t = t + 1 == m_period ? 0 : t + 1;
+			}
+			for (const unsigned int p : m_presieved) {
+				if (p >= first && p <= last) {
+					words[(p - first) >> 7] &= ~(1ULL << (((p - first) >> 1) & 63));
+				}
+			}
+			for (size_t k = skip; k < base.size() && static_cast <value_type> (base[k]) * base[k] <= last; k++) {
+				const value_type p = base[k];
+				value_type j = next[k];
+				for (; j < end; j += p) {
+					words[(j - offset) >> 6] |= 1ULL << ((j - offset) & 63);
+				}
+				next[k] = j;
+			}
+			if (bits & 63) {
+				words[bits >> 6] |= ~0ULL << (bits & 63);
+			}
+			f(first, static_cast <const value_type*> (words.data()), bits);
+		}
+	}
+
+};
+
+template <typename F> inline void for_each_prime(unsigned long long lo, unsigned long long hi, F&& f) {
+	Prime_sieve::for_each(lo, hi, f);
+}
+
+inline unsigned long long count_primes(unsigned long long lo, unsigned long long hi, unsigned int threads = 1) {
+	return Prime_sieve::count(lo, hi, threads);
+}
+
+inline std::vector <unsigned long long> primes_in_range(unsigned long long lo, unsigned long long hi) {
+	return Prime_sieve::primes(lo, hi);
+}
@@ -0,0 +1,208 @@
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
+#ifdef _GLIBCXX_DEBUG
+#include <cassert>
+#endif
+
+// stable lsd radix sort of integer keys (signed or unsigned, up to 64 bits)
+// 8-bit digits for keys of at most 16 bits and 11-bit digits otherwise (3 passes for 32 bits, 6 for 64)
+// one read builds the histograms of every digit, passes where all keys share the digit are skipped
+// signed keys are sorted by flipping the sign bit, so negative keys come first
+// with threads > 1 every pass counts and scatters blocks of the array in parallel
+class Radix_sort {
+
+public:
+
+	// sorts data[0, n) ascending
+	template <typename T> static void sort(T* data, size_t n, unsigned int threads = 1) {
+		static_assert(std::is_integral_v <T>, "radix sort requires integral keys");
+		if (n < m_small) {
+			std::sort(data, data + n);
+			return;
+		}
+		m_sort <T, m_none> (data, nullptr, n, [] (const T& x) -> T { return x; }, threads);
+	}
+
+	// stable sort of data[0, n) by the integral key(x), e.g. pairs by their first member or structs by a field
+	template <typename T, typename F> static void sort_by_key(T* data, size_t n, F&& key, unsigned int threads = 1) {
+		static_assert(std::is_integral_v <std::decay_t <decltype(key(*data))>>, "radix sort requires integral keys");
+		if (n < m_small) {
+			std::stable_sort(data, data + n, [&key] (const T& a, const T& b) -> bool { return key(a) < key(b); });
+			return;
+		}
+		m_sort <T, m_none> (data, nullptr, n, key, threads);
+	}
+
+	// stable sort of keys[0, n) that applies the same permutation to values[0, n) (struct of arrays)
+	template <typename K, typename V> static void sort_pairs(K* keys, V* values, size_t n, unsigned int threads = 1) {
+		static_assert(std::is_integral_v <K>, "radix sort requires integral keys");
+		m_sort <K, V> (keys, values, n, [] (const K& x) -> K { return x; }, threads);
+	}
+
+	// ranks[i] = number of distinct values less than values[i], returns the distinct values in increasing order
+	template <typename T> static std::vector <T> compress(const std::vector <T>& values, std::vector <unsigned int>& ranks, unsigned int threads = 1) {
+		const size_t n = values.size();
+		std::vector <T> keys = values;
+		std::vector <unsigned int> order(n);
+		for (size_t i = 0; i < n; i++) {
+			order[i] = static_cast <unsigned int> (i);
+		}
+		sort_pairs(keys.data(), order.data(), n, threads);
+		ranks.resize(n);
+		size_t distinct = 0;
+		for (size_t i = 0; i < n; i++) {
+			if (!i || keys[i] != keys[distinct - 1]) {
+				keys[distinct++] = keys[i];
+			}
+			ranks[order[i]] = static_cast <unsigned int> (distinct - 1);
+		}
+		keys.resize(distinct);
+		return keys;
+	}
+
+private:
+
+	// below this many elements the comparison sorts win
+	static constexpr const size_t m_small = 256;
+
+	// stands in for the values of a sort without them
+	struct m_none { };
+
+	template <typename U> static constexpr int m_digit_bits() noexcept {
+		return sizeof(U) <= 2 ? 8 : 11;
+	}
+
+	// the unsigned image of a key, order preserving for signed keys too
+	template <typename K> static std::make_unsigned_t <K> m_image(K key) noexcept {
+		using U = std::make_unsigned_t <K>;
+		if constexpr (std::is_signed_v <K>) {
+			return static_cast <U> (key) ^ static_cast <U> (static_cast <U> (1) << (sizeof(U) * 8 - 1));
+		} else {
+			return static_cast <U> (key);
+		}
+	}
+
+	// runs f(0), ..., f(threads - 1) on their own threads, f(0) on the calling one
+	template <typename F> static void m_parallel(unsigned int threads, F&& f) {
+		std::vector <std::thread> workers;
+		workers.reserve(threads - 1);
+		for (unsigned int t = 1; t < threads; t++) {
+			workers.emplace_back([&f, t] () -> void { f(t); });
+		}
+		f(0);
+		for (std::thread& worker : workers) {
+			worker.join();
+		}
+	}
+
+	// values may be null (V = m_none), elements ping-pong between the arrays and the buffers and end up back in place
+	template <typename T, typename V, typename F> static void m_sort(T* data, V* values, size_t n, F&& key, unsigned int threads) {
+		using U = std::make_unsigned_t <std::decay_t <decltype(key(*data))>>;
+		constexpr int bits = m_digit_bits <U> ();
+		constexpr int passes = (static_cast <int> (sizeof(U)) * 8 + bits - 1) / bits;
+		constexpr size_t radix = static_cast <size_t> (1) << bits;
+		constexpr bool has_values = !std::is_same_v <V, m_none>;
+		if (n < 2) {
+			return;
+		}
+		threads = static_cast <unsigned int> (std::max <size_t> (1, std::min <size_t> (threads, n / m_small)));
+		std::vector <T> buffer(n);
+		std::vector <std::conditional_t <has_values, V, m_none>> value_buffer(has_values ? n : 0);
+		T* src = data;
+		T* dst = buffer.data();
+		V* value_src = values;
+		V* value_dst = nullptr;
+		if constexpr (has_values) {
+			value_dst = value_buffer.data();
+		}
+		const size_t block = (n + threads - 1) / threads;
+		// counts[t * radix + d], the number of digits d in block t, turned into the scatter offsets of block t
+		std::vector <size_t> counts(threads * radix);
+		std::vector <size_t> histograms;
+		if (threads == 1) {
+			histograms.assign(passes * radix, 0);
+			for (size_t i = 0; i < n; i++) {
+				const U x = m_image(key(data[i]));
+				for (int p = 0; p < passes; p++) {
+					histograms[p * radix + ((x >> (p * bits)) & (radix - 1))]++;
+				}
+			}
+		}
+		for (int p = 0; p < passes; p++) {
+			const int shift = p * bits;
+			auto digit = [&key, shift] (const T& x) -> size_t {
+				return static_cast <size_t> ((m_image(key(x)) >> shift) & (radix - 1));
+			};
+			if (threads == 1) {
+				std::copy(histograms.begin() + p * radix, histograms.begin() + (p + 1) * radix, counts.begin());
+			} else {
+				std::fill(counts.begin(), counts.end(), 0);
+				m_parallel(threads, [&] (unsigned int t) -> void {
+					size_t* count = counts.data() + t * radix;
+					for (size_t i = t * block; i < std::min(n, (t + 1) * block); i++) {
+						count[digit(src[i])]++;
+					}
+				});
+			}
+			// every key has the digit of the first one
+			const size_t first = digit(src[0]);
+			size_t total = 0;
+			for (unsigned int t = 0; t < threads; t++) {
+				total += counts[t * radix + first];
+			}
+			if (total == n) {
+				continue;
+			}
+			for (size_t d = 0, offset = 0; d < radix; d++) {
+				for (unsigned int t = 0; t < threads; t++) {
+					const size_t count = counts[t * radix + d];
+					counts[t * radix + d] = offset;
+					offset += count;
+				}
+			}
+			m_parallel(threads, [&] (unsigned int t) -> void {
+				size_t* offset = counts.data() + t * radix;
+				for (size_t i = t * block; i < std::min(n, (t + 1) * block); i++) {
+					const size_t j = offset[digit(src[i])]++;
+					if constexpr (has_values) {
+						value_dst[j] = std::move(value_src[i]);
+					}
+					dst[j] = std::move(src[i]);
+				}
+			});
+			std::swap(src, dst);
+			std::swap(value_src, value_dst);
+		}
+		if (src != data) {
+			std::move(src, src + n, data);
+			if constexpr (has_values) {
+				std::move(value_src, value_src + n, values);
+			}
+		}
+	}
+
+};
+
+template <typename T> inline void radix_sort(std::vector <T>& v, unsigned int threads = 1) {
+	Radix_sort::sort(v.data(), v.size(), threads);
+}
+
+template <typename T, typename F> inline void radix_sort_by_key(std::vector <T>& v, F&& key, unsigned int threads = 1) {
+	Radix_sort::sort_by_key(v.data(), v.size(), key, threads);
+}
+
+template <typename K, typename V> inline void radix_sort_pairs(std::vector <K>& keys, std::vector <V>& values, unsigned int threads = 1) {
+#ifdef _GLIBCXX_DEBUG
+	assert(keys.size() == values.size());
+#endif
+	Radix_sort::sort_pairs(keys.data(), values.data(), keys.size(), threads);
+}
+
+template <typename T> inline std::vector <T> compress(const std::vector <T>& values, std::vector <unsigned int>& ranks, unsigned int threads = 1) {
+	return Radix_sort::compress(values, ranks, threads);
+}
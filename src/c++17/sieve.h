@@ -0,0 +1,196 @@
+#pragma once
+
+#include <vector>
+#include <cmath>
+#include <utility>
+#include <algorithm>
+#ifdef _GLIBCXX_DEBUG
+#include <cassert>
+#endif
+
+// linear sieve over 0 ... n in O(n): smallest prime factors, the primes, and (unless compact) phi and mu tables
+// the compact mode keeps only the 32-bit spf table (4 bytes per value) and computes phi/mu by factorizing through it
+class Sieve {
+
+	using size_type = unsigned int;
+
+public:
+
+	inline Sieve(size_type _n = 0, bool _compact = false) :
+	m_spf(static_cast <size_t> (_n) + 1, 0),
+	m_phi(_compact ? 0 : static_cast <size_t> (_n) + 1),
+	m_mu(_compact ? 0 : static_cast <size_t> (_n) + 1),
+	m_primes()
+	{
+		if (_n >= 1 && !_compact) {
+			this->m_phi[1] = 1;
+			this->m_mu[1] = 1;
+		}
+		if (_n >= 2) {
+			this->m_primes.reserve(static_cast <size_t> (1.1 * _n / std::log(static_cast <double> (_n))) + 16);
+		}
+		for (size_type i = 2; i <= _n; i++) {
+			if (!this->m_spf[i]) {
+				this->m_spf[i] = i;
+				this->m_primes.push_back(i);
+				if (!_compact) {
+					this->m_phi[i] = i - 1;
+					this->m_mu[i] = -1;
+				}
+			}
+			const size_type limit = std::min <unsigned long long> (this->m_spf[i], _n / i);
+			for (size_t j = 0; j < this->m_primes.size() && this->m_primes[j] <= limit; j++) {
+				const size_type p = this->m_primes[j], x = i * p;
+				this->m_spf[x] = p;
+				if (!_compact) {
+					if (p == this->m_spf[i]) {
+						this->m_phi[x] = this->m_phi[i] * p;
+						this->m_mu[x] = 0;
+					} else {
+						this->m_phi[x] = this->m_phi[i] * (p - 1);
+						this->m_mu[x] = -this->m_mu[i];
+					}
+				}
+			}
+		}
+	}
+
+	inline size_type size() const noexcept {
+		return static_cast <size_type> (this->m_spf.size() - 1);
+	}
+
+	inline bool compact() const noexcept {
+		return this->m_phi.empty() && !this->m_spf.empty();
+	}
+
+	inline const std::vector <size_type>& primes() const noexcept {
+		return this->m_primes;
+	}
+
+	inline bool is_prime(size_type x) const noexcept {
+		return x >= 2 && this->m_spf[x] == x;
+	}
+
+	// 0 for x < 2
+	inline size_type spf(size_type x) const noexcept {
+		return this->m_spf[x];
+	}
+
+	inline size_type phi(size_type x) const noexcept {
+		if (!this->m_phi.empty()) {
+			return this->m_phi[x];
+		}
+		size_type result = x;
+		while (x > 1) {
+			const size_type p = this->m_spf[x];
+			result -= result / p;
+			while (!(x % p)) {
+				x /= p;
+			}
+		}
+		return result;
+	}
+
+	inline int mu(size_type x) const noexcept {
+		if (!this->m_mu.empty()) {
+			return this->m_mu[x];
+		}
+		int result = 1;
+		while (x > 1) {
+			const size_type p = this->m_spf[x];
+			x /= p;
+			if (!(x % p)) {
+				return 0;
+			}
+			result = -result;
+		}
+		return result;
+	}
+
+	// (prime, exponent) pairs in increasing order of the primes, requires x >= 1
+	inline std::vector <std::pair <size_type, int>> factorize(size_type x) const {
+#ifdef _GLIBCXX_DEBUG
+		assert(x >= 1 && x <= this->size());
+#endif
+		std::vector <std::pair <size_type, int>> result;
+		while (x > 1) {
+			const size_type p = this->m_spf[x];
+			int e = 0;
+			while (!(x % p)) {
+				x /= p;
+				e++;
+			}
+			result.emplace_back(p, e);
+		}
+		return result;
+	}
+
+	// visits phi and mu of every x in [lo, hi) in blocks of consecutive values, without tables covering all of [0, hi)
+	// f(first, phi, mu, count) gets phi[i] and mu[i] of first + i for 0 <= i < count
+	// the primes up to sqrt(hi) are sieved once up front, every block takes m_block values and costs one pass over them
+	// a block's working arrays take 17 bytes per value (about 560 KB), within L2 only on cores with a large one, but
+	// smaller blocks repeat that pass too often once hi is large (2^13 is 2.7x slower at hi = 10^12)
+	template <typename F> static void segmented(unsigned long long lo, unsigned long long hi, F&& f) {
+		lo = std::max(lo, 1ULL);
+		if (lo >= hi) {
+			return;
+		}
+		unsigned long long root = std::sqrt(static_cast <double> (hi));
+		while (root * root >= hi) {
+			root--;
+		}
+		while ((root + 1) * (root + 1) < hi) {
+			root++;
+		}
+		const Sieve small(static_cast <size_type> (root), true);
+		// found[i] is the part of first + i factored so far, phi and mu are built multiplicatively alongside it
+		std::vector <unsigned long long> found(m_block), phi(m_block);
+		std::vector <signed char> mu(m_block);
+		for (unsigned long long first = lo; first < hi; first += m_block) {
+			const size_t count = std::min <unsigned long long> (m_block, hi - first);
+			const unsigned long long last = first + count - 1;
+			std::fill(found.begin(), found.begin() + count, 1ULL);
+			std::fill(phi.begin(), phi.begin() + count, 1ULL);
+			std::fill(mu.begin(), mu.begin() + count, 1);
+			for (const size_type p : small.primes()) {
+				if (static_cast <unsigned long long> (p) * p > last) {
+					break;
+				}
+				for (unsigned long long i = (first + p - 1) / p * p - first; i < count; i += p) {
+					found[i] *= p;
+					phi[i] *= p - 1;
+					mu[i] = -mu[i];
+				}
+				for (unsigned long long q = static_cast <unsigned long long> (p) * p; ; q *= p) {
+					for (unsigned long long i = (first + q - 1) / q * q - first; i < count; i += q) {
+						found[i] *= p;
+						phi[i] *= p;
+						mu[i] = 0;
+					}
+					if (q > last / p) {
+						break;
+					}
+				}
+			}
+			// at most one prime factor above sqrt(hi) remains
+			for (size_t i = 0; i < count; i++) {
+				const unsigned long long rest = (first + i) / found[i];
+				if (rest > 1) {
+					phi[i] *= rest - 1;
+					mu[i] = -mu[i];
+				}
+			}
+			f(first, static_cast <const unsigned long long*> (phi.data()), static_cast <const signed char*> (mu.data()), count);
+		}
+	}
+
+private:
+
+	std::vector <size_type> m_spf;
+	std::vector <size_type> m_phi;
+	std::vector <signed char> m_mu;
+	std::vector <size_type> m_primes;
+
+	static constexpr const size_t m_block = 1 << 15;
+
+};
@@ -0,0 +1,347 @@
+#pragma once
+
+#include <vector>
+#include <chrono>
+#include <utility>
+#include <type_traits>
+#ifdef _GLIBCXX_DEBUG
+#include <cassert>
+#endif
+
+// implicit key treap over a sequence of A, with the same node protocol as Segtree:
+// A::operator + combines adjacent ranges (left + right) and A::update(args...) changes a single element
+// reverse(l, r) is lazy, if A has a reverse() method it is called on the aggregate of every reversed range
+// (needed when + is not commutative), otherwise aggregates are kept as they are
+// nodes live in one contiguous pool with 32-bit links (0 is null), split and merge are iterative
+template <typename A> class Treap {
+
+	using index_type = unsigned int;
+
+public:
+
+	Treap(size_t _reserve = 0) :
+	m_nodes(1),
+	m_root(0),
+	m_seed(static_cast <index_type> (std::chrono::steady_clock::now().time_since_epoch().count()) | 1)
+	{
+		this->m_nodes.reserve(_reserve + 1);
+	}
+
+	// O(n) build, the cartesian tree over random priorities is made with a stack
+	template <typename B> Treap(const std::vector <B>& _v) :
+	Treap(_v.size())
+	{
+		std::vector <index_type> stack;
+		for (const B& entry : _v) {
+			const index_type node = this->m_new_node(A { entry });
+			index_type last = 0;
+			while (!stack.empty() && this->m_nodes[stack.back()].priority < this->m_nodes[node].priority) {
+				last = stack.back();
+				stack.pop_back();
+				this->m_pull(last);
+			}
+			this->m_nodes[node].left = last;
+			if (!stack.empty()) {
+				this->m_nodes[stack.back()].right = node;
+			}
+			stack.push_back(node);
+		}
+		// the bottom of the stack has the largest priority
+		this->m_root = stack.empty() ? 0 : stack.front();
+		while (!stack.empty()) {
+			this->m_pull(stack.back());
+			stack.pop_back();
+		}
+	}
+
+	size_t size() const noexcept {
+		return this->m_nodes[this->m_root].size;
+	}
+
+	bool empty() const noexcept {
+		return !this->m_root;
+	}
+
+	void clear() noexcept {
+		this->m_nodes.resize(1);
+		this->m_free.clear();
+		this->m_root = 0;
+	}
+
+	// inserts A { args... } so that it ends up at position pos
+	template <typename... ARGS> void insert(size_t pos, ARGS&&... args) {
+#ifdef _GLIBCXX_DEBUG
+		assert(pos <= this->size());
+#endif
+		const index_type node = this->m_new_node(A { std::forward <ARGS> (args) ... });
+		const std::pair <index_type, index_type> parts = this->m_split(this->m_root, pos);
+		this->m_root = this->m_merge(this->m_merge(parts.first, node), parts.second);
+	}
+
+	template <typename... ARGS> void push_back(ARGS&&... args) {
+		this->insert(this->size(), std::forward <ARGS> (args) ...);
+	}
+
+	void erase(size_t pos) {
+		this->erase(pos, pos + 1);
+	}
+
+	// erases positions [l, r)
+	void erase(size_t l, size_t r) {
+#ifdef _GLIBCXX_DEBUG
+		assert(l <= r && r <= this->size());
+#endif
+		const std::pair <index_type, index_type> right = this->m_split(this->m_root, r);
+		const std::pair <index_type, index_type> left = this->m_split(right.first, l);
+		this->m_release(left.second);
+		this->m_root = this->m_merge(left.first, right.second);
+	}
+
+	template <typename... ARGS> void update(size_t pos, ARGS&&... args) {
+#ifdef _GLIBCXX_DEBUG
+		assert(pos < this->size());
+#endif
+		const std::pair <index_type, index_type> right = this->m_split(this->m_root, pos + 1);
+		const std::pair <index_type, index_type> left = this->m_split(right.first, pos);
+		this->m_nodes[left.second].value.update(std::forward <ARGS> (args) ...);
+		this->m_pull(left.second);
+		this->m_root = this->m_merge(this->m_merge(left.first, left.second), right.second);
+	}
+
+	A get(size_t pos) {
+#ifdef _GLIBCXX_DEBUG
+		assert(pos < this->size());
+#endif
+		index_type node = this->m_root;
+		while (true) {
+			this->m_push(node);
+			const index_type left = this->m_nodes[node].left;
+			if (pos < this->m_nodes[left].size) {
+				node = left;
+			} else if (pos == this->m_nodes[left].size) {
+				return this->m_nodes[node].value;
+			} else {
+				pos -= this->m_nodes[left].size + 1;
+				node = this->m_nodes[node].right;
+			}
+		}
+	}
+
+	A query() const {
+#ifdef _GLIBCXX_DEBUG
+		assert(this->m_root);
+#endif
+		return this->m_nodes[this->m_root].sum;
+	}
+
+	// aggregate of positions [l, r)
+	A query(size_t l, size_t r) {
+#ifdef _GLIBCXX_DEBUG
+		assert(l < r && r <= this->size());
+#endif
+		const std::pair <index_type, index_type> right = this->m_split(this->m_root, r);
+		const std::pair <index_type, index_type> left = this->m_split(right.first, l);
+		const A result = this->m_nodes[left.second].sum;
+		this->m_root = this->m_merge(this->m_merge(left.first, left.second), right.second);
+		return result;
+	}
+
+	// reverses positions [l, r)
+	void reverse(size_t l, size_t r) {
+#ifdef _GLIBCXX_DEBUG
+		assert(l <= r && r <= this->size());
+#endif
+		const std::pair <index_type, index_type> right = this->m_split(this->m_root, r);
+		const std::pair <index_type, index_type> left = this->m_split(right.first, l);
+		this->m_flip(left.second);
+		this->m_root = this->m_merge(this->m_merge(left.first, left.second), right.second);
+	}
+
+	// cuts out positions [l, r) and pastes them back so they start at position pos
+	void move(size_t l, size_t r, size_t pos) {
+#ifdef _GLIBCXX_DEBUG
+		assert(l <= r && r <= this->size() && pos <= this->size() - (r - l));
+#endif
+		const std::pair <index_type, index_type> right = this->m_split(this->m_root, r);
+		const std::pair <index_type, index_type> left = this->m_split(right.first, l);
+		const std::pair <index_type, index_type> rest = this->m_split(this->m_merge(left.first, right.second), pos);
+		this->m_root = this->m_merge(this->m_merge(rest.first, left.second), rest.second);
+	}
+
+	std::vector <A> current() {
+		std::vector <A> result;
+		result.reserve(this->size());
+		std::vector <index_type> stack;
+		for (index_type node = this->m_root; node || !stack.empty(); ) {
+			if (node) {
+				this->m_push(node);
+				stack.push_back(node);
+				node = this->m_nodes[node].left;
+			} else {
+				node = stack.back();
+				stack.pop_back();
+				result.push_back(this->m_nodes[node].value);
+				node = this->m_nodes[node].right;
+			}
+		}
+		return result;
+	}
+
+private:
+
+	struct m_node {
+		A value { };
+		A sum { };
+		index_type left = 0;
+		index_type right = 0;
+		index_type size = 0;
+		index_type priority = 0;
+		bool reversed = false;
+	};
+
+	template <typename B, typename = void> struct m_has_reverse : std::false_type { };
+	template <typename B> struct m_has_reverse <B, std::void_t <decltype(std::declval <B&> ().reverse())>> : std::true_type { };
+
+	std::vector <m_node> m_nodes;
+	std::vector <index_type> m_free;
+	// nodes whose children changed during the last split or merge, pulled in reverse order
+	std::vector <index_type> m_path;
+	index_type m_root;
+	index_type m_seed;
+
+	index_type m_random() noexcept {
+		this->m_seed ^= this->m_seed << 13;
+		this->m_seed ^= this->m_seed >> 17;
+		this->m_seed ^= this->m_seed << 5;
+		return this->m_seed;
+	}
+
+	index_type m_new_node(A&& value) {
+		index_type node;
+		if (!this->m_free.empty()) {
+			node = this->m_free.back();
+			this->m_free.pop_back();
+		} else {
+			node = static_cast <index_type> (this->m_nodes.size());
+			this->m_nodes.emplace_back();
+		}
+		m_node& result = this->m_nodes[node];
+		result.sum = result.value = std::move(value);
+		result.left = result.right = 0;
+		result.size = 1;
+		result.priority = this->m_random();
+		result.reversed = false;
+		return node;
+	}
+
+	// hands every node of the subtree back to the pool
+	void m_release(index_type node) {
+		if (!node) {
+			return;
+		}
+		const size_t first = this->m_free.size();
+		this->m_free.push_back(node);
+		for (size_t i = first; i < this->m_free.size(); i++) {
+			const m_node& current = this->m_nodes[this->m_free[i]];
+			if (current.left) {
+				this->m_free.push_back(current.left);
+			}
+			if (current.right) {
+				this->m_free.push_back(current.right);
+			}
+		}
+	}
+
+	void m_flip(index_type node) {
+		if (!node) {
+			return;
+		}
+		this->m_nodes[node].reversed ^= true;
+		if constexpr (m_has_reverse <A>::value) {
+			this->m_nodes[node].sum.reverse();
+		}
+	}
+
+	// a reversed flag means the children still have to be swapped, the sum of the node is already reversed
+	void m_push(index_type node) {
+		m_node& current = this->m_nodes[node];
+		if (current.reversed) {
+			std::swap(current.left, current.right);
+			this->m_flip(current.left);
+			this->m_flip(current.right);
+			current.reversed = false;
+		}
+	}
+
+	void m_pull(index_type node) {
+		m_node& current = this->m_nodes[node];
+		const m_node& left = this->m_nodes[current.left];
+		const m_node& right = this->m_nodes[current.right];
+		current.size = left.size + 1 + right.size;
+		current.sum = current.value;
+		if (current.left) {
+			current.sum = left.sum + current.sum;
+		}
+		if (current.right) {
+			current.sum = current.sum + right.sum;
+		}
+	}
+
+	void m_pull_path() {
+		while (!this->m_path.empty()) {
+			this->m_pull(this->m_path.back());
+			this->m_path.pop_back();
+		}
+	}
+
+	// (first k positions, the rest), walking down once and hooking nodes onto the two spines
+	std::pair <index_type, index_type> m_split(index_type node, size_t k) {
+		index_type left = 0, right = 0;
+		index_type* left_hook = &left;
+		index_type* right_hook = &right;
+		while (node) {
+			this->m_push(node);
+			this->m_path.push_back(node);
+			m_node& current = this->m_nodes[node];
+			const size_t left_size = this->m_nodes[current.left].size;
+			if (left_size < k) {
+				k -= left_size + 1;
+				*left_hook = node;
+				left_hook = &current.right;
+				node = current.right;
+			} else {
+				*right_hook = node;
+				right_hook = &current.left;
+				node = current.left;
+			}
+		}
+		*left_hook = *right_hook = 0;
+		this->m_pull_path();
+		return { left, right };
+	}
+
+	// every position of a comes before every position of b
+	index_type m_merge(index_type a, index_type b) {
+		index_type result = 0;
+		index_type* hook = &result;
+		while (a && b) {
+			if (this->m_nodes[a].priority > this->m_nodes[b].priority) {
+				this->m_push(a);
+				this->m_path.push_back(a);
+				*hook = a;
+				hook = &this->m_nodes[a].right;
+				a = this->m_nodes[a].right;
+			} else {
+				this->m_push(b);
+				this->m_path.push_back(b);
+				*hook = b;
+				hook = &this->m_nodes[b].left;
+				b = this->m_nodes[b].left;
+			}
+		}
+		*hook = a ? a : b;
+		this->m_pull_path();
+		return result;
+	}
+
+};
@@ -0,0 +1,178 @@
+#pragma once
+
+#include <array>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <algorithm>
+
+// factorials, inverse factorials and inverses modulo M::mod() for a compile time modulus (e.g. Mint)
+// tables grow on demand (or up front through reserve()) in blocks that are never moved
+// so reads of already computed entries are lock free and safe from any thread, growth is serialized by a mutex
+// entries exist for 0 <= x < M::mod(), beyond that fac() is 0 and choose() uses lucas' theorem (requires a prime modulus)
+template <typename M> class Comb {
+
+public:
+
+	// makes entries 0 ... n available
+	static void reserve(size_t n) {
+		n = std::min(n, static_cast <size_t> (M::mod()) - 1);
+		if (n >= m_storage.size.load(std::memory_order_acquire)) {
+			m_grow(n);
+		}
+	}
+
+	static M fac(size_t x) {
+		if (x >= static_cast <size_t> (M::mod())) {
+			return M(0);
+		}
+		return m_get(x).fac;
+	}
+
+	// requires x < M::mod()
+	static M inv_fac(size_t x) {
+		return m_get(x).inv_fac;
+	}
+
+	// x^-1, requires 0 < x < M::mod()
+	static M inv(size_t x) {
+		return m_get(x).inv;
+	}
+
+	static M choose(unsigned long long n, unsigned long long k) {
+		if (k > n) {
+			return M(0);
+		}
+		if (n >= static_cast <unsigned long long> (M::mod())) {
+			return lucas(n, k);
+		}
+		return m_get(n).fac * m_get(k).inv_fac * m_get(n - k).inv_fac;
+	}
+
+	// number of ordered selections of k out of n
+	static M perm(size_t n, size_t k) {
+		if (k > n) {
+			return M(0);
+		}
+		const size_t p = M::mod();
+		if (n >= p) {
+			// k consecutive factors, zero as soon as one of them is a multiple of p
+			const size_t r = n % p;
+			return r < k ? M(0) : m_get(r).fac * m_get(r - k).inv_fac;
+		}
+		return m_get(n).fac * m_get(n - k).inv_fac;
+	}
+
+	// choose(n, k) as the product of choose() over the base M::mod() digits of n and k
+	static M lucas(unsigned long long n, unsigned long long k) {
+		const unsigned long long p = M::mod();
+		M result = 1;
+		while ((n || k) && result != M(0)) {
+			const unsigned long long nd = n % p, kd = k % p;
+			if (kd > nd) {
+				return M(0);
+			}
+			result *= m_get(nd).fac * m_get(kd).inv_fac * m_get(nd - kd).inv_fac;
+			n /= p;
+			k /= p;
+		}
+		return result;
+	}
+
+private:
+
+	struct Entry {
+		M fac;
+		M inv_fac;
+		M inv;
+	};
+
+	// block b holds the entries [2^b - 1, 2^(b + 1) - 1), so size is always of the form 2^b - 1
+	struct Storage {
+		std::atomic <size_t> size { 0 };
+		std::mutex mutex;
+		std::unique_ptr <Entry[]> blocks[sizeof(size_t) * 8];
+	};
+
+	static inline Storage m_storage;
+
+	static inline Entry& m_at(size_t x) noexcept {
+		const int block = sizeof(unsigned long long) * 8 - 1 - __builtin_clzll(x + 1);
+		return m_storage.blocks[block][x + 1 - (static_cast <size_t> (1) << block)];
+	}
+
+	static inline const Entry& m_get(size_t x) {
+		if (x >= m_storage.size.load(std::memory_order_acquire)) [[unlikely]] {
+			m_grow(x);
+		}
+		return m_at(x);
+	}
+
+	static void m_grow(size_t x) {
+		std::lock_guard <std::mutex> lock(m_storage.mutex);
+		const size_t old_size = m_storage.size.load(std::memory_order_relaxed);
+		if (x < old_size) {
+			return;
+		}
+		// at least double, never past the modulus, where factorials stop being invertible
+		const size_t limit = static_cast <size_t> (M::mod());
+		size_t new_size = old_size;
+		while (new_size <= x || new_size < (old_size << 1 | 1)) {
+			m_storage.blocks[__builtin_ctzll(~new_size)].reset(new Entry[new_size + 1]);
+			new_size = new_size << 1 | 1;
+		}
+		const size_t end = std::min(new_size, limit);
+		for (size_t i = old_size; i < end; i++) {
+			m_at(i).fac = i ? m_at(i - 1).fac * M(i) : M(1);
+		}
+		if (old_size < end) {
+			m_at(end - 1).inv_fac = inverse(m_at(end - 1).fac);
+			for (size_t i = end - 1; i > old_size; i--) {
+				m_at(i - 1).inv_fac = m_at(i).inv_fac * M(i);
+			}
+			for (size_t i = old_size; i < end; i++) {
+				m_at(i).inv = i ? m_at(i).inv_fac * m_at(i - 1).fac : M(0);
+			}
+		}
+		m_storage.size.store(new_size, std::memory_order_release);
+	}
+
+};
+
+// factorial tables computed at compile time for 0 <= x < N, usable in constant expressions
+// e.g. static constexpr Comb_table <mi, 1000> table;
+template <typename M, size_t N> class Comb_table {
+
+	static_assert(N > 0);
+
+public:
+
+	constexpr Comb_table() noexcept : m_fac(), m_inv_fac() {
+		this->m_fac[0] = M(1);
+		for (size_t i = 1; i < N; i++) {
+			this->m_fac[i] = this->m_fac[i - 1] * M(i);
+		}
+		this->m_inv_fac[N - 1] = inverse(this->m_fac[N - 1]);
+		for (size_t i = N - 1; i > 0; i--) {
+			this->m_inv_fac[i - 1] = this->m_inv_fac[i] * M(i);
+		}
+	}
+
+	constexpr M fac(size_t x) const noexcept {
+		return this->m_fac[x];
+	}
+
+	constexpr M inv_fac(size_t x) const noexcept {
+		return this->m_inv_fac[x];
+	}
+
+	constexpr M choose(size_t n, size_t k) const noexcept {
+		return k > n ? M(0) : this->m_fac[n] * this->m_inv_fac[k] * this->m_inv_fac[n - k];
+	}
+
+private:
+
+	std::array <M, N> m_fac;
+	std::array <M, N> m_inv_fac;
+
+};
@@ -0,0 +1,265 @@
+#pragma once
+
+#include "phi.h"
+#include "inverse.h"
+
+#include <limits>
+#include <iostream>
+#include <vector>
+#include <cassert>
+
+// mod int with the modulus chosen at runtime
+// every thread has its own modulus per ID, use different IDs to work under several moduli at once
+template <int ID = 0> class Dmint {
+
+	struct Context;
+
+public:
+
+	Dmint(int _value = 0) noexcept : m_value(m_fix(static_cast <long long> (_value))) { }
+	template <typename A> Dmint(const A& _value) noexcept : m_value(m_fix(static_cast <long long> (_value))) { }
+	Dmint(const Dmint& _mint) noexcept : m_value(_mint.m_value) { }
+
+	Dmint <ID>& operator = (const Dmint <ID>& rhs) noexcept {
+		this->m_value = rhs.m_value;
+		return *this;
+	}
+
+	explicit operator int () const noexcept {
+		return this->m_value;
+	}
+
+	static int mod() noexcept {
+		return m_ctx.mod;
+	}
+
+	// resets the factorial tables, all existing values become meaningless
+	static void set_mod(int mod, bool is_prime = false) {
+		assert(mod >= 1);
+		m_ctx.mod = mod;
+		m_ctx.im = ~0ULL / static_cast <unsigned int> (mod) + 1;
+		m_ctx.phi = is_prime ? mod - 1 : phi <int> (mod);
+		m_ctx.is_prime = is_prime;
+		m_tables.fac.assign(2, Dmint <ID> (1));
+		m_tables.inv_fac.assign(2, Dmint <ID> (1));
+	}
+
+	// the modulus of the calling thread, set_context() installs it on another thread (e.g. the workers of a parallel routine)
+	static Context context() noexcept {
+		return m_ctx;
+	}
+
+	static void set_context(const Context& ctx) {
+		const bool changed = ctx.mod != m_ctx.mod;
+		m_ctx = ctx;
+		if (changed) {
+			m_tables.fac.assign(2, Dmint <ID> (1));
+			m_tables.inv_fac.assign(2, Dmint <ID> (1));
+		}
+	}
+
+	bool operator == (const Dmint <ID>& rhs) const noexcept {
+		return (int) *this == (int) rhs;
+	}
+
+	bool operator != (const Dmint <ID>& rhs) const noexcept {
+		return !(*this == rhs);
+	}
+
+	std::strong_ordering operator <=> (const Dmint <ID>& rhs) const noexcept {
+		return (int) *this < (int) rhs ? std::strong_ordering::less :
+		(int) *this > (int) rhs ? std::strong_ordering::greater : std::strong_ordering::equivalent;
+	}
+
+	Dmint <ID> operator - () const noexcept {
+		Dmint <ID> result;
+		result.m_value = this->m_value ? m_ctx.mod - this->m_value : 0;
+		return result;
+	}
+
+	Dmint <ID>& operator += (const Dmint <ID>& rhs) noexcept {
+		this->m_value += rhs.m_value - m_ctx.mod;
+		this->m_value += this->m_value < 0 ? m_ctx.mod : 0;
+		return *this;
+	}
+
+	Dmint <ID>& operator -= (const Dmint <ID>& rhs) noexcept {
+		this->m_value += (this->m_value -= rhs.m_value) < 0 ? m_ctx.mod : 0;
+		return *this;
+	}
+
+	Dmint <ID>& operator *= (const Dmint <ID>& rhs) noexcept {
+		this->m_value = m_mul(this->m_value, rhs.m_value);
+		return *this;
+	}
+
+	Dmint <ID>& operator /= (const Dmint <ID>& rhs) noexcept {
+		return *this *= inverse(rhs);
+	}
+
+	// zero if the value is not invertible
+	friend Dmint <ID> inverse(const Dmint <ID>& den) noexcept {
+		if (!den.m_value) {
+			return Dmint <ID> (0);
+		}
+		return Dmint <ID> (inverse <long long> (den.m_value, m_ctx.mod));
+	}
+
+	template <typename A> static Dmint <ID> pow(Dmint <ID> base, A exponent) noexcept {
+		static_assert(std::is_integral_v <A>);
+		if (exponent < static_cast <A> (0)) {
+			return pow(base, exponent % m_ctx.phi + m_ctx.phi);
+		}
+		if (m_ctx.is_prime && exponent >= m_ctx.phi) {
+			exponent %= m_ctx.phi;
+		}
+		if (exponent == static_cast <A> (0)) {
+			return Dmint <ID> (1);
+		}
+		Dmint <ID> result(base != 0);
+		while (exponent) {
+			if (exponent & static_cast <A> (1)) {
+				result *= base;
+			}
+			exponent >>= static_cast <A> (1);
+			base *= base;
+		}
+		return result;
+	}
+
+	Dmint <ID>& operator ++ () noexcept {
+		return *this += 1;
+	}
+
+	Dmint <ID> operator ++ (int) noexcept {
+		Dmint <ID> result = *this;
+		++*this;
+		return result;
+	}
+
+	Dmint <ID>& operator -- () noexcept {
+		return *this -= 1;
+	}
+
+	Dmint <ID> operator -- (int) noexcept {
+		Dmint <ID> result = *this;
+		--*this;
+		return result;
+	}
+
+	friend Dmint <ID> operator + (Dmint <ID> mint, const Dmint <ID>& other) noexcept {
+		return mint += other;
+	}
+
+	friend Dmint <ID> operator - (Dmint <ID> mint, const Dmint <ID>& other) noexcept {
+		return mint -= other;
+	}
+
+	friend Dmint <ID> operator * (Dmint <ID> mint, const Dmint <ID>& other) noexcept {
+		return mint *= other;
+	}
+
+	friend Dmint <ID> operator / (Dmint <ID> mint, const Dmint <ID>& other) noexcept {
+		return mint /= other;
+	}
+
+	static inline Dmint <ID> fac(size_t x) noexcept {
+		if (x >= (1ULL << (sizeof(size_t) * 8 - 1))) [[unlikely]] {
+			return Dmint <ID> (0);
+		}
+		std::vector <Dmint <ID>>& result = m_tables.fac;
+		if (x < result.size()) [[likely]] {
+			return result[x];
+		}
+		const size_t next = x + (x >> static_cast <size_t> (4));
+		const size_t prev_size = result.size();
+		result.resize(next + 1);
+		for (size_t i = prev_size; i <= next; i++) {
+			result[i] = result[i - 1] * Dmint <ID> (i);
+		}
+		return result[x];
+	}
+
+	static inline Dmint <ID> inv_fac(size_t x) noexcept {
+		if (x >= (1ULL << (sizeof(size_t) * 8 - 1))) [[unlikely]] {
+			return Dmint <ID> (0);
+		}
+		std::vector <Dmint <ID>>& result = m_tables.inv_fac;
+		if (x < result.size()) [[likely]] {
+			return result[x];
+		}
+		const size_t next = x + (x >> static_cast <size_t> (4));
+		const size_t prev_size = result.size();
+		result.resize(next + 1);
+		result[next] = inverse(fac(next));
+		for (size_t i = next - 1; i >= prev_size; i--) {
+			result[i] = result[i + 1] * Dmint <ID> (i + 1);
+		}
+		return result[x];
+	}
+
+	static inline Dmint <ID> choose(size_t n, size_t k) noexcept {
+		if (k > n || n >= (1ULL << (sizeof(size_t) * 8 - 1))) [[unlikely]] {
+			return Dmint <ID> (0);
+		}
+		return fac(n) * inv_fac(k) * inv_fac(n - k);
+	}
+
+	friend std::ostream& operator << (std::ostream& stream, const Dmint <ID>& mint) {
+		return stream << (int) mint;
+	}
+
+	friend std::istream& operator >> (std::istream& stream, Dmint <ID>& mint) {
+		stream >> mint.m_value;
+		mint.m_value = m_fix(static_cast <long long> (mint.m_value));
+		return stream;
+	}
+
+	template <std::istream& STREAM = std::cin> void readl() {
+		long long i64v;
+		STREAM >> i64v;
+		this->m_value = m_fix(i64v);
+	}
+
+private:
+
+	int m_value;
+
+	// trivially constructible so that access does not go through a thread local init guard
+	struct Context {
+		int mod;
+		int phi;
+		bool is_prime;
+		// ceil(2^64 / mod), barrett reciprocal
+		unsigned long long im;
+	};
+
+	struct Tables {
+		std::vector <Dmint <ID>> fac = std::vector <Dmint <ID>> (2, Dmint <ID> (1));
+		std::vector <Dmint <ID>> inv_fac = std::vector <Dmint <ID>> (2, Dmint <ID> (1));
+	};
+
+	static inline thread_local Context m_ctx = { 1000000007, 1000000006, true, ~0ULL / 1000000007U + 1 };
+	static inline thread_local Tables m_tables;
+
+	// requires a, b < mod, exact for any mod < 2^31
+	static int m_mul(int a, int b) noexcept {
+		const unsigned long long z = static_cast <unsigned long long> (a) * static_cast <unsigned int> (b);
+		const unsigned long long x = static_cast <unsigned long long> ((static_cast <unsigned __int128> (z) * m_ctx.im) >> 64);
+		const unsigned long long y = x * static_cast <unsigned int> (m_ctx.mod);
+		return static_cast <int> (z - y + (z < y ? m_ctx.mod : 0));
+	}
+
+	static int m_fix(long long i64v) noexcept {
+		if (0LL <= i64v && i64v < m_ctx.mod) [[likely]] {
+			return i64v;
+		}
+		i64v %= m_ctx.mod;
+		return i64v < 0 ? i64v + m_ctx.mod : i64v;
+	}
+
+};
+
+#ifndef no_dmi
+typedef Dmint <0> dmi;
+#endif
@@ -0,0 +1,313 @@
+#pragma once
+
+#include <vector>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+#ifdef _GLIBCXX_DEBUG
+#include <cassert>
+#endif
+
+// set of integers in [0, n) as a hierarchy of 64-bit words, n / 8 bytes plus about 1/63 of that for the upper levels
+// bit i of level h + 1 is set iff word i of level h is non zero, so insert(), erase(), next() and prev()
+// touch one word per level and cost O(log_64 n) with ctz/clz
+class Fast_set {
+
+	using size_type = unsigned int;
+
+	class m_iterator;
+
+public:
+
+	using key_type = size_type;
+	using value_type = size_type;
+	using iterator = m_iterator;
+	using const_iterator = m_iterator;
+
+	static constexpr const size_type npos = ~static_cast <size_type> (0);
+
+	inline Fast_set(size_type _n = 0) :
+	m_n(_n),
+	m_size(0)
+	{
+		this->m_allocate();
+	}
+
+	// bit i of bitmap[i >> 6] tells whether i is in the set, in O(n / 64)
+	inline Fast_set(size_type _n, const std::vector <unsigned long long>& bitmap) :
+	m_n(_n),
+	m_size(0)
+	{
+		this->m_allocate();
+		std::copy(bitmap.begin(), bitmap.begin() + std::min(bitmap.size(), this->m_levels[0].size()), this->m_levels[0].begin());
+		this->m_rebuild();
+	}
+
+	// from keys in any order (duplicates are ignored), in O(n / 64 + number of keys)
+	template <typename IT> inline Fast_set(size_type _n, IT first, IT last) :
+	m_n(_n),
+	m_size(0)
+	{
+		this->m_allocate();
+		for (; first != last; ++first) {
+#ifdef _GLIBCXX_DEBUG
+			assert(static_cast <size_type> (*first) < this->m_n);
+#endif
+			this->m_levels[0][static_cast <size_type> (*first) >> 6] |= 1ULL << (static_cast <size_type> (*first) & 63);
+		}
+		this->m_rebuild();
+	}
+
+	inline size_type size() const noexcept {
+		return this->m_size;
+	}
+
+	inline bool empty() const noexcept {
+		return !this->m_size;
+	}
+
+	// the bound n, keys lie in [0, n)
+	inline size_type bound() const noexcept {
+		return this->m_n;
+	}
+
+	// word i of the bitmap, keys 64 * i to 64 * i + 63
+	inline unsigned long long word(size_type i) const noexcept {
+		return this->m_levels[0][i];
+	}
+
+	inline void clear() noexcept {
+		for (std::vector <unsigned long long>& level : this->m_levels) {
+			std::fill(level.begin(), level.end(), 0ULL);
+		}
+		this->m_size = 0;
+	}
+
+	inline iterator begin() const noexcept {
+		return iterator(this, this->m_or_end(this->next(0)));
+	}
+
+	inline iterator end() const noexcept {
+		return iterator(this, this->m_n);
+	}
+
+	inline std::pair <iterator, bool> insert(size_type key) noexcept {
+#ifdef _GLIBCXX_DEBUG
+		assert(key < this->m_n);
+#endif
+		if (this->m_test(key)) [[unlikely]] {
+			return { iterator(this, key), false };
+		}
+		for (size_t h = 0, x = key; h < this->m_levels.size(); h++, x >>= 6) {
+			unsigned long long& word = this->m_levels[h][x >> 6];
+			const bool was_empty = !word;
+			word |= 1ULL << (x & 63);
+			if (!was_empty) [[likely]] {
+				break;
+			}
+		}
+		this->m_size++;
+		return { iterator(this, key), true };
+	}
+
+	// number of erased keys (0 or 1)
+	inline size_type erase(size_type key) noexcept {
+		if (key >= this->m_n || !this->m_test(key)) {
+			return 0;
+		}
+		for (size_t h = 0, x = key; h < this->m_levels.size(); h++, x >>= 6) {
+			unsigned long long& word = this->m_levels[h][x >> 6];
+			word &= ~(1ULL << (x & 63));
+			if (word) [[likely]] {
+				break;
+			}
+		}
+		this->m_size--;
+		return 1;
+	}
+
+	// the iterator following the erased key
+	inline iterator erase(iterator it) noexcept {
+		const size_type key = *it;
+		this->erase(key);
+		return this->lower_bound(key);
+	}
+
+	inline size_type count(size_type key) const noexcept {
+		return key < this->m_n && this->m_test(key);
+	}
+
+	inline iterator find(size_type key) const noexcept {
+		return iterator(this, this->count(key) ? key : this->m_n);
+	}
+
+	inline iterator lower_bound(size_type key) const noexcept {
+		return iterator(this, this->m_or_end(this->next(key)));
+	}
+
+	inline iterator upper_bound(size_type key) const noexcept {
+		return iterator(this, key == npos ? this->m_n : this->m_or_end(this->next(key + 1)));
+	}
+
+	// smallest key >= key, npos if none
+	inline size_type next(size_type key) const noexcept {
+		if (key >= this->m_n) {
+			return npos;
+		}
+		size_t x = key;
+		for (size_t h = 0; h < this->m_levels.size(); h++) {
+			if ((x >> 6) >= this->m_levels[h].size()) {
+				break;
+			}
+			const unsigned long long word = this->m_levels[h][x >> 6] & (~0ULL << (x & 63));
+			if (word) {
+				x = (x & ~static_cast <size_t> (63)) | __builtin_ctzll(word);
+				while (h--) {
+					x = x << 6 | __builtin_ctzll(this->m_levels[h][x]);
+				}
+				return static_cast <size_type> (x);
+			}
+			x = (x >> 6) + 1;
+		}
+		return npos;
+	}
+
+	// largest key <= key, npos if none
+	inline size_type prev(size_type key) const noexcept {
+		if (!this->m_n) {
+			return npos;
+		}
+		size_t x = std::min(key, this->m_n - 1);
+		for (size_t h = 0; h < this->m_levels.size(); h++) {
+			const unsigned long long word = this->m_levels[h][x >> 6] & (~0ULL >> (63 - (x & 63)));
+			if (word) {
+				x = (x & ~static_cast <size_t> (63)) | (63 - __builtin_clzll(word));
+				while (h--) {
+					x = x << 6 | (63 - __builtin_clzll(this->m_levels[h][x]));
+				}
+				return static_cast <size_type> (x);
+			}
+			if (!(x >> 6)) {
+				break;
+			}
+			x = (x >> 6) - 1;
+		}
+		return npos;
+	}
+
+	// calls f(key) for every key in [l, r) in increasing order, bits of a word are walked directly
+	// and empty stretches are jumped over with next(), so O(number of keys + number of non empty words * log_64 n)
+	template <typename F> inline void for_each(size_type l, size_type r, F&& f) const {
+		r = std::min(r, this->m_n);
+		for (size_type x = this->next(l); x < r; ) {
+			const size_type w = x >> 6;
+			for (unsigned long long word = this->m_levels[0][w] & (~0ULL << (x & 63)); word; word &= word - 1) {
+				const size_type key = w << 6 | __builtin_ctzll(word);
+				if (key >= r) {
+					return;
+				}
+				f(key);
+			}
+			x = this->next((w + 1) << 6);
+		}
+	}
+
+private:
+
+	class m_iterator {
+
+	public:
+
+		using iterator_category = std::bidirectional_iterator_tag;
+		using difference_type = std::ptrdiff_t;
+		using value_type = size_type;
+		using reference = const size_type&;
+		using pointer = const size_type*;
+
+		inline m_iterator() noexcept : m_set(nullptr), m_key(0) { }
+
+		inline m_iterator(const Fast_set* _set, size_type _key) noexcept : m_set(_set), m_key(_key) { }
+
+		inline reference operator * () const noexcept {
+			return this->m_key;
+		}
+
+		inline pointer operator -> () const noexcept {
+			return &this->m_key;
+		}
+
+		inline m_iterator& operator ++ () noexcept {
+			this->m_key = this->m_set->m_or_end(this->m_set->next(this->m_key + 1));
+			return *this;
+		}
+
+		inline m_iterator operator ++ (int) noexcept {
+			m_iterator result = *this;
+			++*this;
+			return result;
+		}
+
+		inline m_iterator& operator -- () noexcept {
+			this->m_key = this->m_set->prev(this->m_key - 1);
+			return *this;
+		}
+
+		inline m_iterator operator -- (int) noexcept {
+			m_iterator result = *this;
+			--*this;
+			return result;
+		}
+
+		inline bool operator == (const m_iterator& rhs) const noexcept {
+			return this->m_key == rhs.m_key;
+		}
+
+	private:
+
+		const Fast_set* m_set;
+		size_type m_key;
+
+	};
+
+	size_type m_n;
+	size_type m_size;
+	// m_levels[0] holds the keys, bit i of m_levels[h + 1] is set iff word i of m_levels[h] is non zero
+	std::vector <std::vector <unsigned long long>> m_levels;
+
+	inline size_type m_or_end(size_type key) const noexcept {
+		return key == npos ? this->m_n : key;
+	}
+
+	inline bool m_test(size_type key) const noexcept {
+		return this->m_levels[0][key >> 6] >> (key & 63) & 1;
+	}
+
+	inline void m_allocate() {
+		this->m_levels.clear();
+		size_t words = (static_cast <size_t> (this->m_n) + 63) >> 6;
+		do {
+			this->m_levels.emplace_back(std::max <size_t> (words, 1), 0ULL);
+			words = (words + 63) >> 6;
+		} while (this->m_levels.back().size() > 1);
+	}
+
+	// recomputes the upper levels and the size from the bottom level in linear time, bits at or past n are dropped
+	inline void m_rebuild() noexcept {
+		if ((this->m_n & 63) || !this->m_n) {
+			this->m_levels[0][this->m_n >> 6] &= (1ULL << (this->m_n & 63)) - 1;
+		}
+		this->m_size = 0;
+		for (const unsigned long long word : this->m_levels[0]) {
+			this->m_size += __builtin_popcountll(word);
+		}
+		for (size_t h = 1; h < this->m_levels.size(); h++) {
+			std::fill(this->m_levels[h].begin(), this->m_levels[h].end(), 0ULL);
+			for (size_t i = 0; i < this->m_levels[h - 1].size(); i++) {
+				if (this->m_levels[h - 1][i]) {
+					this->m_levels[h][i >> 6] |= 1ULL << (i & 63);
+				}
+			}
+		}
+	}
+
+};
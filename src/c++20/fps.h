@@ -0,0 +1,428 @@
+#pragma once
+
+#include "ntt.h"
+#include "modular.h"
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <cassert>
+
+// formal power series over an NTT friendly Mint, (*this)[i] is the coefficient of x^i
+// inv, log, exp, sqrt and pow take the number of wanted terms n, and work in O(n log n) through newton iteration
+// the newton loops keep their transform buffers alive across iterations instead of reallocating them
+template <typename M> class Fps : public std::vector <M> {
+
+public:
+
+	using std::vector <M>::vector;
+
+	Fps(const std::vector <M>& _v) : std::vector <M> (_v) { }
+	Fps(std::vector <M>&& _v) noexcept : std::vector <M> (std::move(_v)) { }
+
+	// removes trailing zero coefficients
+	Fps <M>& shrink() noexcept {
+		while (!this->empty() && this->back() == M(0)) {
+			this->pop_back();
+		}
+		return *this;
+	}
+
+	Fps <M> prefix(size_t n) const {
+		Fps <M> result(this->begin(), this->begin() + std::min(n, this->size()));
+		result.resize(n);
+		return result;
+	}
+
+	Fps <M>& operator += (const Fps <M>& rhs) {
+		if (rhs.size() > this->size()) {
+			this->resize(rhs.size());
+		}
+		for (size_t i = 0; i < rhs.size(); i++) {
+			(*this)[i] += rhs[i];
+		}
+		return *this;
+	}
+
+	Fps <M>& operator -= (const Fps <M>& rhs) {
+		if (rhs.size() > this->size()) {
+			this->resize(rhs.size());
+		}
+		for (size_t i = 0; i < rhs.size(); i++) {
+			(*this)[i] -= rhs[i];
+		}
+		return *this;
+	}
+
+	Fps <M>& operator *= (const Fps <M>& rhs) {
+		return *this = Fps <M> (convolution(this->data(), this->size(), rhs.data(), rhs.size()));
+	}
+
+	Fps <M>& operator *= (const M& rhs) noexcept {
+		for (M& x : *this) {
+			x *= rhs;
+		}
+		return *this;
+	}
+
+	// polynomial division, the remainder is dropped
+	Fps <M>& operator /= (const Fps <M>& rhs) {
+		return *this = this->divmod(rhs).first;
+	}
+
+	Fps <M>& operator %= (const Fps <M>& rhs) {
+		return *this = this->divmod(rhs).second;
+	}
+
+	Fps <M> operator - () const {
+		Fps <M> result(*this);
+		for (M& x : result) {
+			x = -x;
+		}
+		return result;
+	}
+
+	friend Fps <M> operator + (Fps <M> fps, const Fps <M>& other) {
+		return fps += other;
+	}
+
+	friend Fps <M> operator - (Fps <M> fps, const Fps <M>& other) {
+		return fps -= other;
+	}
+
+	friend Fps <M> operator * (const Fps <M>& fps, const Fps <M>& other) {
+		return Fps <M> (convolution(fps.data(), fps.size(), other.data(), other.size()));
+	}
+
+	friend Fps <M> operator * (Fps <M> fps, const M& other) noexcept {
+		return fps *= other;
+	}
+
+	friend Fps <M> operator / (const Fps <M>& fps, const Fps <M>& other) {
+		return fps.divmod(other).first;
+	}
+
+	friend Fps <M> operator % (const Fps <M>& fps, const Fps <M>& other) {
+		return fps.divmod(other).second;
+	}
+
+	M operator () (const M& x) const noexcept {
+		M result = 0;
+		for (size_t i = this->size(); i--; ) {
+			result = result * x + (*this)[i];
+		}
+		return result;
+	}
+
+	Fps <M> derivative() const {
+		if (this->size() <= 1) {
+			return { };
+		}
+		Fps <M> result(this->size() - 1);
+		for (size_t i = 1; i < this->size(); i++) {
+			result[i - 1] = (*this)[i] * M(i);
+		}
+		return result;
+	}
+
+	Fps <M> integral() const {
+		const std::vector <M> inv = m_inverses(this->size() + 1);
+		Fps <M> result(this->size() + 1);
+		for (size_t i = 0; i < this->size(); i++) {
+			result[i + 1] = (*this)[i] * inv[i + 1];
+		}
+		return result;
+	}
+
+	// quotient and remainder, the remainder has fewer terms than rhs (after trailing zeros are removed from rhs)
+	std::pair <Fps <M>, Fps <M>> divmod(Fps <M> rhs) const {
+		rhs.shrink();
+		assert(!rhs.empty());
+		Fps <M> lhs(*this);
+		lhs.shrink();
+		if (lhs.size() < rhs.size()) {
+			return { Fps <M> (), lhs };
+		}
+		const size_t k = lhs.size() - rhs.size() + 1;
+		Fps <M> rl(lhs.rbegin(), lhs.rbegin() + k);
+		Fps <M> rr(rhs.rbegin(), rhs.rend());
+		Fps <M> quo = (rl * rr.inv(k)).prefix(k);
+		std::reverse(quo.begin(), quo.end());
+		Fps <M> rem = lhs - quo * rhs;
+		rem.resize(rhs.size() - 1);
+		return { quo.shrink(), rem.shrink() };
+	}
+
+	// requires (*this)[0] != 0
+	Fps <M> inv(size_t n) const {
+		assert(!this->empty() && (*this)[0] != M(0));
+		Fps <M> result;
+		result.reserve(m_ceil(n));
+		result.push_back(inverse((*this)[0]));
+		std::vector <M> f, g;
+		f.reserve(m_ceil(n) << 1);
+		g.reserve(m_ceil(n) << 1);
+		for (size_t m = 1; m < n; m <<= 1) {
+			f.assign(m << 1, M(0));
+			std::copy(this->begin(), this->begin() + std::min(this->size(), m << 1), f.begin());
+			g.assign(m << 1, M(0));
+			std::copy(result.begin(), result.end(), g.begin());
+			ntt(f);
+			ntt(g);
+			for (size_t i = 0; i < (m << 1); i++) {
+				f[i] *= g[i];
+			}
+			intt(f);
+			// f * g = 1 + O(x^m), the low half is known
+			std::fill(f.begin(), f.begin() + m, M(0));
+			ntt(f);
+			for (size_t i = 0; i < (m << 1); i++) {
+				f[i] *= g[i];
+			}
+			intt(f);
+			for (size_t i = m; i < (m << 1); i++) {
+				result.push_back(-f[i]);
+			}
+		}
+		result.resize(n);
+		return result;
+	}
+
+	Fps <M> inv() const {
+		return this->inv(this->size());
+	}
+
+	// requires (*this)[0] == 1
+	Fps <M> log(size_t n) const {
+		assert(!this->empty() && (*this)[0] == M(1));
+		if (n <= 1) [[unlikely]] {
+			return Fps <M> (n);
+		}
+		Fps <M> result = (this->prefix(n).derivative() * this->inv(n - 1)).prefix(n - 1).integral();
+		return result;
+	}
+
+	Fps <M> log() const {
+		return this->log(this->size());
+	}
+
+	// requires (*this)[0] == 0
+	Fps <M> exp(size_t n) const {
+		assert(this->empty() || (*this)[0] == M(0));
+		if (n <= 2) [[unlikely]] {
+			Fps <M> result = { M(1), this->size() > 1 ? (*this)[1] : M(0) };
+			result.resize(n);
+			return result;
+		}
+		const size_t cap = m_ceil(n) << 1;
+		const std::vector <M> inv = m_inverses(cap);
+		// b = exp(f) mod x^m, c = b^-1 mod x^(m / 2), z2 = ntt(c) of length m
+		Fps <M> b = { M(1), this->size() > 1 ? (*this)[1] : M(0) };
+		Fps <M> c = { M(1) };
+		std::vector <M> x, y, z, z1, z2 = { M(1), M(1) };
+		b.reserve(cap);
+		c.reserve(cap);
+		for (std::vector <M>* buf : { &x, &y, &z, &z1, &z2 }) {
+			buf->reserve(cap);
+		}
+		for (size_t m = 2; m < n; m <<= 1) {
+			y.assign(b.begin(), b.end());
+			y.resize(m << 1);
+			ntt(y);
+			// extend c to b^-1 mod x^m
+			z1.swap(z2);
+			z.resize(m);
+			for (size_t i = 0; i < m; i++) {
+				z[i] = y[i] * z1[i];
+			}
+			intt(z);
+			std::fill(z.begin(), z.begin() + (m >> 1), M(0));
+			ntt(z);
+			for (size_t i = 0; i < m; i++) {
+				z[i] *= -z1[i];
+			}
+			intt(z);
+			c.insert(c.end(), z.begin() + (m >> 1), z.end());
+			z2.assign(c.begin(), c.end());
+			z2.resize(m << 1);
+			ntt(z2);
+			// x = b' - b * f' mod x^(2m - 1), shifted up by m - 1 since the low part vanishes
+			x.assign(m, M(0));
+			for (size_t i = 1; i < std::min(this->size(), m); i++) {
+				x[i - 1] = (*this)[i] * M(i);
+			}
+			ntt(x);
+			for (size_t i = 0; i < m; i++) {
+				x[i] *= y[i];
+			}
+			intt(x);
+			for (size_t i = 1; i < b.size(); i++) {
+				x[i - 1] -= b[i] * M(i);
+			}
+			x.resize(m << 1);
+			for (size_t i = 0; i + 1 < m; i++) {
+				x[m + i] = x[i];
+				x[i] = M(0);
+			}
+			ntt(x);
+			for (size_t i = 0; i < (m << 1); i++) {
+				x[i] *= z2[i];
+			}
+			intt(x);
+			// x = f - integral(x) on [m, 2m), only the low 2m - 1 terms of x are meaningful
+			for (size_t i = (m << 1) - 1; i; i--) {
+				x[i] = x[i - 1] * inv[i];
+			}
+			x[0] = M(0);
+			for (size_t i = m; i < std::min(this->size(), m << 1); i++) {
+				x[i] += (*this)[i];
+			}
+			std::fill(x.begin(), x.begin() + m, M(0));
+			ntt(x);
+			for (size_t i = 0; i < (m << 1); i++) {
+				x[i] *= y[i];
+			}
+			intt(x);
+			b.insert(b.end(), x.begin() + m, x.end());
+		}
+		b.resize(n);
+		return b;
+	}
+
+	Fps <M> exp() const {
+		return this->exp(this->size());
+	}
+
+	// empty result if no square root exists
+	Fps <M> sqrt(size_t n) const {
+		size_t d = 0;
+		while (d < this->size() && (*this)[d] == M(0)) {
+			d++;
+		}
+		if (d == this->size() || (d >> 1) >= n) {
+			return Fps <M> (n);
+		}
+		M root;
+		if ((d & 1) || !Modular <M>::sqrt((*this)[d], root)) {
+			return { };
+		}
+		const size_t len = n - (d >> 1);
+		const Fps <M> h(this->begin() + d, this->begin() + std::min(this->size(), d + len));
+		const M half = -inverse(M(2));
+		// b = sqrt(h) mod x^m, c = b^-1 mod x^m, z = ntt(c) of length 2m
+		Fps <M> b = { root };
+		Fps <M> c = { inverse(root) };
+		std::vector <M> x, y, z;
+		b.reserve(m_ceil(len));
+		c.reserve(m_ceil(len));
+		for (std::vector <M>* buf : { &x, &y, &z }) {
+			buf->reserve(m_ceil(len) << 1);
+		}
+		for (size_t m = 1; m < len; m <<= 1) {
+			// b^2 - h = O(x^m), so b -= (b^2 - h) * c / 2 only needs its terms on [m, 2m)
+			y.assign(b.begin(), b.end());
+			y.resize(m << 1);
+			ntt(y);
+			for (size_t i = 0; i < (m << 1); i++) {
+				y[i] *= y[i];
+			}
+			intt(y);
+			x.assign(m << 1, M(0));
+			for (size_t i = 0; i < m; i++) {
+				x[i] = y[m + i] - (m + i < h.size() ? h[m + i] : M(0));
+			}
+			z.assign(c.begin(), c.end());
+			z.resize(m << 1);
+			ntt(z);
+			ntt(x);
+			for (size_t i = 0; i < (m << 1); i++) {
+				x[i] *= z[i];
+			}
+			intt(x);
+			for (size_t i = 0; i < m; i++) {
+				b.push_back(x[i] * half);
+			}
+			if ((m << 1) >= len) {
+				break;
+			}
+			// extend c to b^-1 mod x^(2m), the doubling step of inv with ntt(c) already in z
+			y.assign(b.begin(), b.end());
+			ntt(y);
+			for (size_t i = 0; i < (m << 1); i++) {
+				y[i] *= z[i];
+			}
+			intt(y);
+			std::fill(y.begin(), y.begin() + m, M(0));
+			ntt(y);
+			for (size_t i = 0; i < (m << 1); i++) {
+				y[i] *= z[i];
+			}
+			intt(y);
+			for (size_t i = m; i < (m << 1); i++) {
+				c.push_back(-y[i]);
+			}
+		}
+		Fps <M> result = std::move(b);
+		result.resize(len);
+		result.insert(result.begin(), d >> 1, M(0));
+		return result;
+	}
+
+	Fps <M> sqrt() const {
+		return this->sqrt(this->size());
+	}
+
+	// (*this)^k mod x^n
+	Fps <M> pow(unsigned long long k, size_t n) const {
+		if (!n) {
+			return Fps <M> (0);
+		}
+		if (!k) {
+			Fps <M> result(n);
+			if (n) {
+				result[0] = M(1);
+			}
+			return result;
+		}
+		size_t d = 0;
+		while (d < this->size() && (*this)[d] == M(0)) {
+			d++;
+		}
+		if (d == this->size() || (d && k >= (n + d - 1) / d)) {
+			return Fps <M> (n);
+		}
+		const size_t len = n - d * k;
+		const M lead = (*this)[d];
+		Fps <M> h(this->begin() + d, this->begin() + std::min(this->size(), d + len));
+		h *= inverse(lead);
+		Fps <M> result = (h.log(len) * M(k % M::mod())).exp(len);
+		result *= M::pow(lead, k);
+		result.insert(result.begin(), d * k, M(0));
+		return result;
+	}
+
+	Fps <M> pow(unsigned long long k) const {
+		return this->pow(k, this->size());
+	}
+
+private:
+
+	static size_t m_ceil(size_t n) noexcept {
+		size_t result = 1;
+		while (result < n) {
+			result <<= 1;
+		}
+		return result;
+	}
+
+	// inverses of 0 ... n - 1 (0 maps to 0)
+	static std::vector <M> m_inverses(size_t n) {
+		std::vector <M> result(std::max(n, static_cast <size_t> (2)));
+		result[1] = M(1);
+		for (size_t i = 2; i < n; i++) {
+			result[i] = -result[M::mod() % i] * M(M::mod() / i);
+		}
+		return result;
+	}
+
+};
@@ -0,0 +1,476 @@
+#pragma once
+
+#include <vector>
+#include <chrono>
+#include <memory>
+#include <utility>
+#include <iterator>
+#include <functional>
+#include <type_traits>
+#ifdef _GLIBCXX_DEBUG
+#include <cassert>
+#endif
+
+// splitmix64 over a seed drawn once per run, so no input can be prepared against it
+// integers and pointers are mixed directly, pairs combine their halves, anything else goes through std::hash first
+template <typename KEY> struct Splitmix_hash {
+
+	size_t operator () (const KEY& key) const noexcept {
+		if constexpr (std::is_integral_v <KEY> || std::is_enum_v <KEY>) {
+			return m_mix(static_cast <unsigned long long> (key));
+		} else if constexpr (std::is_pointer_v <KEY>) {
+			return m_mix(reinterpret_cast <unsigned long long> (key));
+		} else {
+			return m_mix(std::hash <KEY> () (key));
+		}
+	}
+
+private:
+
+	static inline const unsigned long long m_seed = static_cast <unsigned long long> (std::chrono::steady_clock::now().time_since_epoch().count());
+
+	static unsigned long long m_mix(unsigned long long x) noexcept {
+		x += m_seed + 0x9e3779b97f4a7c15ULL;
+		x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+		x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+		return x ^ (x >> 31);
+	}
+
+};
+
+template <typename A, typename B> struct Splitmix_hash <std::pair <A, B>> {
+
+	size_t operator () (const std::pair <A, B>& key) const noexcept {
+		return Splitmix_hash <unsigned long long> () (Splitmix_hash <A> () (key.first) * 0x9e3779b97f4a7c15ULL + Splitmix_hash <B> () (key.second));
+	}
+
+};
+
+// flat hash set/map with swiss table style open addressing, a set when VALUE is void and a map otherwise
+// every slot has a control byte (empty, deleted or the low 7 bits of its hash), a lookup compares 16 control bytes
+// at once (sse2 where available, a plain loop otherwise) and only touches the slots whose byte matches
+// the table doubles at 7/8 load, insert() and reserve() invalidate iterators, erase() does not
+template <typename KEY, typename VALUE = void, typename HASH = Splitmix_hash <KEY>, typename EQUAL = std::equal_to <KEY>> class Hash_table {
+
+	static constexpr const bool m_is_set = std::is_void_v <VALUE>;
+	// placeholder for the values of a set, never stored
+	using m_mapped = std::conditional_t <m_is_set, char, VALUE>;
+
+	template <bool CONST> class m_iterator;
+
+public:
+
+	using size_type = size_t;
+	using key_type = KEY;
+	using mapped_type = VALUE;
+	using value_type = std::conditional_t <m_is_set, KEY, std::pair <const KEY, m_mapped>>;
+	using iterator = m_iterator <false>;
+	using const_iterator = m_iterator <true>;
+
+	Hash_table(const HASH& _hash = HASH(), const EQUAL& _equal = EQUAL()) :
+	m_slots(nullptr),
+	m_capacity(0),
+	m_size(0),
+	m_growth(0),
+	m_hash(_hash),
+	m_equal(_equal)
+	{ }
+
+	template <typename IT> Hash_table(IT first, IT last, const HASH& _hash = HASH(), const EQUAL& _equal = EQUAL()) :
+	Hash_table(_hash, _equal)
+	{
+		if constexpr (std::is_base_of_v <std::forward_iterator_tag, typename std::iterator_traits <IT>::iterator_category>) {
+			this->reserve(std::distance(first, last));
+		}
+		for (; first != last; ++first) {
+			this->insert(*first);
+		}
+	}
+
+	Hash_table(const Hash_table& other) :
+	Hash_table(other.m_hash, other.m_equal)
+	{
+		if (!other.m_capacity) {
+			return;
+		}
+		this->m_ctrl = other.m_ctrl;
+		this->m_slots = m_allocate(other.m_capacity);
+		this->m_capacity = other.m_capacity;
+		this->m_size = other.m_size;
+		this->m_growth = other.m_growth;
+		for (size_t i = 0; i < this->m_capacity; i++) {
+			if (this->m_ctrl[i] >= 0) {
+				new (this->m_slots + i) value_type(other.m_slots[i]);
+			}
+		}
+	}
+
+	Hash_table(Hash_table&& other) noexcept :
+	Hash_table(other.m_hash, other.m_equal)
+	{
+		this->swap(other);
+	}
+
+	Hash_table& operator = (Hash_table other) noexcept {
+		this->swap(other);
+		return *this;
+	}
+
+	~Hash_table() {
+		this->m_release();
+	}
+
+	void swap(Hash_table& other) noexcept {
+		std::swap(this->m_ctrl, other.m_ctrl);
+		std::swap(this->m_slots, other.m_slots);
+		std::swap(this->m_capacity, other.m_capacity);
+		std::swap(this->m_size, other.m_size);
+		std::swap(this->m_growth, other.m_growth);
+		std::swap(this->m_hash, other.m_hash);
+		std::swap(this->m_equal, other.m_equal);
+	}
+
+	size_type size() const noexcept {
+		return this->m_size;
+	}
+
+	bool empty() const noexcept {
+		return !this->m_size;
+	}
+
+	// number of slots, a power of two (or 0 before the first insertion)
+	size_type capacity() const noexcept {
+		return this->m_capacity;
+	}
+
+	// keeps the slots
+	void clear() noexcept {
+		for (size_t i = 0; i < this->m_capacity; i++) {
+			if (this->m_ctrl[i] >= 0) {
+				this->m_slots[i].~value_type();
+			}
+		}
+		std::fill(this->m_ctrl.begin(), this->m_ctrl.end(), m_empty);
+		this->m_size = 0;
+		this->m_growth = m_max_load(this->m_capacity);
+	}
+
+	// makes room for n elements without rehashing
+	void reserve(size_type n) {
+		size_t capacity = m_width;
+		while (m_max_load(capacity) < n) {
+			capacity <<= 1;
+		}
+		if (capacity > this->m_capacity) {
+			this->m_rehash(capacity);
+		}
+	}
+
+	iterator begin() noexcept {
+		return iterator(this, this->m_skip(0));
+	}
+
+	const_iterator begin() const noexcept {
+		return const_iterator(this, this->m_skip(0));
+	}
+
+	iterator end() noexcept {
+		return iterator(this, this->m_capacity);
+	}
+
+	const_iterator end() const noexcept {
+		return const_iterator(this, this->m_capacity);
+	}
+
+	std::pair <iterator, bool> insert(const value_type& value) {
+		return this->m_insert(m_key_of(value), value);
+	}
+
+	std::pair <iterator, bool> insert(value_type&& value) {
+		return this->m_insert(m_key_of(value), std::move(value));
+	}
+
+	m_mapped& operator [] (const KEY& key) {
+		static_assert(!m_is_set, "operator [] requires a map");
+		return this->m_insert(key, key, m_mapped()).first->second;
+	}
+
+	// number of erased keys (0 or 1)
+	size_type erase(const KEY& key) {
+		const size_t i = this->m_find(key, this->m_hash(key));
+		if (i == this->m_capacity) {
+			return 0;
+		}
+		this->m_erase(i);
+		return 1;
+	}
+
+	// the iterator following the erased element
+	iterator erase(const_iterator it) {
+		this->m_erase(it.m_index);
+		return iterator(this, this->m_skip(it.m_index + 1));
+	}
+
+	iterator find(const KEY& key) {
+		return iterator(this, this->m_find(key, this->m_hash(key)));
+	}
+
+	const_iterator find(const KEY& key) const {
+		return const_iterator(this, this->m_find(key, this->m_hash(key)));
+	}
+
+	size_type count(const KEY& key) const {
+		return this->m_find(key, this->m_hash(key)) != this->m_capacity;
+	}
+
+private:
+
+	// slots per group, a group may start at any slot, the first m_width - 1 control bytes are repeated after the last one
+	static constexpr const size_t m_width = 16;
+	// full slots hold 7 hash bits, so their control byte is non negative
+	static constexpr const signed char m_empty = -128;
+	static constexpr const signed char m_deleted = -2;
+
+	template <bool CONST> class m_iterator {
+
+		using table_type = std::conditional_t <CONST, const Hash_table, Hash_table>;
+
+	public:
+
+		using iterator_category = std::forward_iterator_tag;
+		using difference_type = std::ptrdiff_t;
+		using value_type = typename Hash_table::value_type;
+		using reference = std::conditional_t <CONST || m_is_set, const value_type&, value_type&>;
+		using pointer = std::conditional_t <CONST || m_is_set, const value_type*, value_type*>;
+
+		m_iterator() noexcept : m_table(nullptr), m_index(0) { }
+
+		m_iterator(table_type* _table, size_t _index) noexcept : m_table(_table), m_index(_index) { }
+
+		operator m_iterator <true> () const noexcept {
+			return m_iterator <true> (this->m_table, this->m_index);
+		}
+
+		reference operator * () const noexcept {
+			return this->m_table->m_slots[this->m_index];
+		}
+
+		pointer operator -> () const noexcept {
+			return this->m_table->m_slots + this->m_index;
+		}
+
+		m_iterator& operator ++ () noexcept {
+			this->m_index = this->m_table->m_skip(this->m_index + 1);
+			return *this;
+		}
+
+		m_iterator operator ++ (int) noexcept {
+			m_iterator result = *this;
+			++*this;
+			return result;
+		}
+
+		bool operator == (const m_iterator& rhs) const noexcept {
+			return this->m_index == rhs.m_index;
+		}
+
+	private:
+
+		friend class Hash_table;
+
+		table_type* m_table;
+		size_t m_index;
+
+	};
+
+	// m_capacity + m_width - 1 control bytes
+	std::vector <signed char> m_ctrl;
+	value_type* m_slots;
+	size_t m_capacity;
+	size_t m_size;
+	// insertions into empty slots left before the next rehash
+	size_t m_growth;
+	HASH m_hash;
+	EQUAL m_equal;
+
+	static const KEY& m_key_of(const value_type& value) noexcept {
+		if constexpr (m_is_set) {
+			return value;
+		} else {
+			return value.first;
+		}
+	}
+
+	static size_t m_max_load(size_t capacity) noexcept {
+		return capacity - (capacity >> 3);
+	}
+
+	static value_type* m_allocate(size_t n) {
+		return std::allocator <value_type> ().allocate(n);
+	}
+
+	void m_release() noexcept {
+		if (!this->m_slots) {
+			return;
+		}
+		this->clear();
+		std::allocator <value_type> ().deallocate(this->m_slots, this->m_capacity);
+	}
+
+#ifdef __SSE2__
+	// a group of control bytes as a gcc vector, with pmovmskb through its builtin no intrinsics header is needed
+	// (prep drops non sl2 includes, so <emmintrin.h> would not survive it)
+	typedef char m_bytes __attribute__ ((vector_size(m_width)));
+
+	static m_bytes m_load(const signed char* group) noexcept {
+		m_bytes result;
+		__builtin_memcpy(&result, group, m_width);
+		return result;
+	}
+#endif
+
+	// bit i is set iff control byte i of the group is c
+	static unsigned int m_match(const signed char* group, signed char c) noexcept {
+#ifdef __SSE2__
+		return __builtin_ia32_pmovmskb128(reinterpret_cast <m_bytes> (m_load(group) == static_cast <char> (c)));
+#else
+		unsigned int result = 0;
+		for (size_t i = 0; i < m_width; i++) {
+			result |= static_cast <unsigned int> (group[i] == c) << i;
+		}
+		return result;
+#endif
+	}
+
+	// bit i is set iff slot i of the group is empty or deleted
+	static unsigned int m_match_free(const signed char* group) noexcept {
+#ifdef __SSE2__
+		return __builtin_ia32_pmovmskb128(m_load(group));
+#else
+		unsigned int result = 0;
+		for (size_t i = 0; i < m_width; i++) {
+			result |= static_cast <unsigned int> (group[i] < 0) << i;
+		}
+		return result;
+#endif
+	}
+
+	void m_set_ctrl(size_t i, signed char c) noexcept {
+		this->m_ctrl[i] = c;
+		if (i < m_width - 1) {
+			this->m_ctrl[i + this->m_capacity] = c;
+		}
+	}
+
+	// groups are probed at triangular offsets, with a power of two capacity every group start is visited
+	// the slot of key, m_capacity if missing
+	size_t m_find(const KEY& key, size_t hash) const noexcept {
+		if (!this->m_size) {
+			return this->m_capacity;
+		}
+		const size_t mask = this->m_capacity - 1;
+		const signed char h2 = static_cast <signed char> (hash & 127);
+		for (size_t offset = (hash >> 7) & mask, step = m_width; ; offset = (offset + step) & mask, step += m_width) {
+			const signed char* group = this->m_ctrl.data() + offset;
+			for (unsigned int match = m_match(group, h2); match; match &= match - 1) {
+				const size_t i = (offset + __builtin_ctz(match)) & mask;
+				if (this->m_equal(m_key_of(this->m_slots[i]), key)) [[likely]] {
+					return i;
+				}
+			}
+			if (m_match(group, m_empty)) {
+				return this->m_capacity;
+			}
+		}
+	}
+
+	// the first empty or deleted slot on the probe sequence of hash
+	size_t m_free_slot(size_t hash) const noexcept {
+		const size_t mask = this->m_capacity - 1;
+		for (size_t offset = (hash >> 7) & mask, step = m_width; ; offset = (offset + step) & mask, step += m_width) {
+			const unsigned int free = m_match_free(this->m_ctrl.data() + offset);
+			if (free) {
+				return (offset + __builtin_ctz(free)) & mask;
+			}
+		}
+	}
+
+	// the first full slot at or after i, m_capacity if none
+	size_t m_skip(size_t i) const noexcept {
+		for (; i < this->m_capacity; i += m_width) {
+			const unsigned int full = ~m_match_free(this->m_ctrl.data() + i) & ((1U << m_width) - 1);
+			if (full) {
+				return std::min(i + __builtin_ctz(full), this->m_capacity);
+			}
+		}
+		return this->m_capacity;
+	}
+
+	template <typename... ARGS> std::pair <iterator, bool> m_insert(const KEY& key, ARGS&&... args) {
+		const size_t hash = this->m_hash(key);
+		size_t i = this->m_find(key, hash);
+		if (i != this->m_capacity) {
+			return { iterator(this, i), false };
+		}
+		if (!this->m_capacity) [[unlikely]] {
+			this->m_rehash(m_width);
+		}
+		i = this->m_free_slot(hash);
+		if (!this->m_growth && this->m_ctrl[i] != m_deleted) [[unlikely]] {
+			// doubles, unless at most half of the load is live and the rest are tombstones
+			this->m_rehash(this->m_size > (m_max_load(this->m_capacity) >> 1) ? this->m_capacity << 1 : this->m_capacity);
+			i = this->m_free_slot(hash);
+		}
+		new (this->m_slots + i) value_type(std::forward <ARGS> (args) ...);
+		this->m_growth -= this->m_ctrl[i] == m_empty;
+		this->m_set_ctrl(i, static_cast <signed char> (hash & 127));
+		this->m_size++;
+		return { iterator(this, i), true };
+	}
+
+	void m_erase(size_t i) noexcept {
+#ifdef _GLIBCXX_DEBUG
+		assert(i < this->m_capacity && this->m_ctrl[i] >= 0);
+#endif
+		this->m_slots[i].~value_type();
+		this->m_size--;
+		// if every window of m_width slots around i has an empty slot, no probe ever passed i and it can be empty again
+		const unsigned int empty_before = m_match(this->m_ctrl.data() + ((i - m_width) & (this->m_capacity - 1)), m_empty);
+		const unsigned int empty_after = m_match(this->m_ctrl.data() + i, m_empty);
+		if (empty_before && empty_after && static_cast <size_t> (__builtin_ctz(empty_after) + __builtin_clz(empty_before << (32 - m_width))) < m_width) {
+			this->m_set_ctrl(i, m_empty);
+			this->m_growth++;
+		} else {
+			this->m_set_ctrl(i, m_deleted);
+		}
+	}
+
+	void m_rehash(size_t capacity) {
+		std::vector <signed char> ctrl(capacity + m_width - 1, m_empty);
+		value_type* const slots = this->m_slots;
+		const size_t old_capacity = this->m_capacity;
+		this->m_ctrl.swap(ctrl);
+		this->m_slots = m_allocate(capacity);
+		this->m_capacity = capacity;
+		this->m_growth = m_max_load(capacity) - this->m_size;
+		for (size_t i = 0; i < old_capacity; i++) {
+			if (ctrl[i] >= 0) {
+				const size_t hash = this->m_hash(m_key_of(slots[i]));
+				const size_t j = this->m_free_slot(hash);
+				new (this->m_slots + j) value_type(std::move(slots[i]));
+				slots[i].~value_type();
+				this->m_set_ctrl(j, static_cast <signed char> (hash & 127));
+			}
+		}
+		if (slots) {
+			std::allocator <value_type> ().deallocate(slots, old_capacity);
+		}
+	}
+
+};
+
+template <typename KEY, typename HASH = Splitmix_hash <KEY>, typename EQUAL = std::equal_to <KEY>>
+using hash_set = Hash_table <KEY, void, HASH, EQUAL>;
+
+template <typename KEY, typename VALUE, typename HASH = Splitmix_hash <KEY>, typename EQUAL = std::equal_to <KEY>>
+using hash_map = Hash_table <KEY, VALUE, HASH, EQUAL>;
@@ -0,0 +1,342 @@
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <utility>
+#include <iostream>
+#include <algorithm>
+#include <cassert>
+
+// dense row major matrix over a 32-bit mod int type M (e.g. Mint, Dmint)
+// products are tiled over result rows, result columns and k, and accumulate raw values in 64-bit lanes
+// that are only brought back below a multiple of mod^2 (a compare and subtract, no division) once they could overflow
+// det(), rank() and inv() use gaussian elimination and require a prime modulus
+// mul() and pow() with threads > 1 hand the calling thread's modulus to the workers when M keeps it thread local (Dmint)
+template <typename M> class Matrix {
+
+public:
+
+	Matrix(size_t _rows = 0, size_t _cols = 0) :
+	m_rows(_rows),
+	m_cols(_cols),
+	m_items(_rows * _cols, M(0))
+	{ }
+
+	Matrix(const std::vector <std::vector <M>>& _v) :
+	m_rows(_v.size()),
+	m_cols(_v.empty() ? 0 : _v[0].size()),
+	m_items()
+	{
+		this->m_items.reserve(this->m_rows * this->m_cols);
+		for (const std::vector <M>& row : _v) {
+			assert(row.size() == this->m_cols);
+			this->m_items.insert(this->m_items.end(), row.begin(), row.end());
+		}
+	}
+
+	static Matrix <M> identity(size_t n) {
+		Matrix <M> result(n, n);
+		for (size_t i = 0; i < n; i++) {
+			result[i][i] = M(1);
+		}
+		return result;
+	}
+
+	size_t rows() const noexcept {
+		return this->m_rows;
+	}
+
+	size_t cols() const noexcept {
+		return this->m_cols;
+	}
+
+	M* operator [] (size_t row) noexcept {
+		return this->m_items.data() + row * this->m_cols;
+	}
+
+	const M* operator [] (size_t row) const noexcept {
+		return this->m_items.data() + row * this->m_cols;
+	}
+
+	bool operator == (const Matrix <M>& rhs) const noexcept {
+		return this->m_rows == rhs.m_rows && this->m_cols == rhs.m_cols && this->m_items == rhs.m_items;
+	}
+
+	bool operator != (const Matrix <M>& rhs) const noexcept {
+		return !(*this == rhs);
+	}
+
+	Matrix <M>& operator += (const Matrix <M>& rhs) noexcept {
+		assert(this->m_rows == rhs.m_rows && this->m_cols == rhs.m_cols);
+		for (size_t i = 0; i < this->m_items.size(); i++) {
+			this->m_items[i] += rhs.m_items[i];
+		}
+		return *this;
+	}
+
+	Matrix <M>& operator -= (const Matrix <M>& rhs) noexcept {
+		assert(this->m_rows == rhs.m_rows && this->m_cols == rhs.m_cols);
+		for (size_t i = 0; i < this->m_items.size(); i++) {
+			this->m_items[i] -= rhs.m_items[i];
+		}
+		return *this;
+	}
+
+	Matrix <M>& operator *= (const M& rhs) noexcept {
+		for (M& x : this->m_items) {
+			x *= rhs;
+		}
+		return *this;
+	}
+
+	Matrix <M>& operator *= (const Matrix <M>& rhs) {
+		return *this = this->mul(rhs);
+	}
+
+	friend Matrix <M> operator + (Matrix <M> matrix, const Matrix <M>& other) noexcept {
+		return matrix += other;
+	}
+
+	friend Matrix <M> operator - (Matrix <M> matrix, const Matrix <M>& other) noexcept {
+		return matrix -= other;
+	}
+
+	friend Matrix <M> operator * (Matrix <M> matrix, const M& other) noexcept {
+		return matrix *= other;
+	}
+
+	friend Matrix <M> operator * (const Matrix <M>& matrix, const Matrix <M>& other) {
+		return matrix.mul(other);
+	}
+
+	// rows of the result are split evenly among the given number of threads
+	Matrix <M> mul(const Matrix <M>& rhs, unsigned int threads = 1) const {
+		assert(this->m_cols == rhs.m_rows);
+		Matrix <M> result(this->m_rows, rhs.m_cols);
+		threads = std::max(1U, std::min <unsigned int> (threads, this->m_rows));
+		if (threads == 1) {
+			this->m_mul(rhs, result, 0, this->m_rows);
+			return result;
+		}
+		std::vector <std::thread> workers;
+		workers.reserve(threads - 1);
+		const size_t chunk = (this->m_rows + threads - 1) / threads;
+		for (unsigned int t = 1; t < threads; t++) {
+			const size_t begin = std::min(this->m_rows, chunk * t);
+			const size_t end = std::min(this->m_rows, begin + chunk);
+			workers.push_back(m_spawn([this, &rhs, &result, begin, end] () -> void { this->m_mul(rhs, result, begin, end); }));
+		}
+		this->m_mul(rhs, result, 0, std::min(this->m_rows, chunk));
+		for (std::thread& worker : workers) {
+			worker.join();
+		}
+		return result;
+	}
+
+	template <typename A> Matrix <M> pow(A exponent, unsigned int threads = 1) const {
+		assert(this->m_rows == this->m_cols && exponent >= static_cast <A> (0));
+		Matrix <M> result = identity(this->m_rows);
+		Matrix <M> base = *this;
+		while (exponent) {
+			if (exponent & static_cast <A> (1)) {
+				result = result.mul(base, threads);
+			}
+			exponent >>= static_cast <A> (1);
+			if (exponent) {
+				base = base.mul(base, threads);
+			}
+		}
+		return result;
+	}
+
+	Matrix <M> transpose() const {
+		Matrix <M> result(this->m_cols, this->m_rows);
+		for (size_t i = 0; i < this->m_rows; i++) {
+			for (size_t j = 0; j < this->m_cols; j++) {
+				result[j][i] = (*this)[i][j];
+			}
+		}
+		return result;
+	}
+
+	M det() const {
+		assert(this->m_rows == this->m_cols);
+		Matrix <M> a = *this;
+		M result = 1;
+		for (size_t col = 0; col < this->m_cols; col++) {
+			const size_t pivot = a.m_find_pivot(col, col);
+			if (pivot == this->m_rows) [[unlikely]] {
+				return M(0);
+			}
+			if (pivot != col) {
+				a.m_swap_rows(pivot, col);
+				result = -result;
+			}
+			result *= a[col][col];
+			a.m_eliminate(col, col, false);
+		}
+		return result;
+	}
+
+	size_t rank() const {
+		Matrix <M> a = *this;
+		size_t result = 0;
+		for (size_t col = 0; col < this->m_cols && result < this->m_rows; col++) {
+			const size_t pivot = a.m_find_pivot(result, col);
+			if (pivot == this->m_rows) [[unlikely]] {
+				continue;
+			}
+			a.m_swap_rows(pivot, result);
+			a.m_eliminate(result, col, false);
+			result++;
+		}
+		return result;
+	}
+
+	// empty (0 x 0) matrix if singular
+	Matrix <M> inv() const {
+		assert(this->m_rows == this->m_cols);
+		const size_t n = this->m_rows;
+		// gauss-jordan on [A | I]
+		Matrix <M> a(n, n << 1);
+		for (size_t i = 0; i < n; i++) {
+			std::copy((*this)[i], (*this)[i] + n, a[i]);
+			a[i][n + i] = M(1);
+		}
+		for (size_t col = 0; col < n; col++) {
+			const size_t pivot = a.m_find_pivot(col, col);
+			if (pivot == n) [[unlikely]] {
+				return Matrix <M> ();
+			}
+			a.m_swap_rows(pivot, col);
+			a.m_eliminate(col, col, true);
+		}
+		Matrix <M> result(n, n);
+		for (size_t i = 0; i < n; i++) {
+			std::copy(a[i] + n, a[i] + (n << 1), result[i]);
+		}
+		return result;
+	}
+
+	friend std::ostream& operator << (std::ostream& stream, const Matrix <M>& matrix) {
+		for (size_t i = 0; i < matrix.m_rows; i++) {
+			for (size_t j = 0; j < matrix.m_cols; j++) {
+				stream << matrix[i][j] << (j + 1 == matrix.m_cols ? "\n" : " ");
+			}
+		}
+		return stream;
+	}
+
+private:
+
+	size_t m_rows;
+	size_t m_cols;
+	std::vector <M> m_items;
+
+	// a thread running f, under the modulus of the calling thread if M keeps it thread local
+	template <typename F> static std::thread m_spawn(F&& f) {
+		if constexpr (requires { M::set_context(M::context()); }) {
+			return std::thread([f, context = M::context()] () -> void {
+				M::set_context(context);
+				f();
+			});
+		} else {
+			return std::thread(std::forward <F> (f));
+		}
+	}
+
+	// tile sizes: result columns, result rows and rows of rhs (the k dimension)
+	// an m_depth x m_block tile of rhs (64 KiB) stays in L2 while every row of the row tile walks it,
+	// and the m_height x m_block accumulators (32 KiB) stay cached for the whole k range
+	static constexpr const size_t m_block = 256;
+	static constexpr const size_t m_height = 16;
+	static constexpr const size_t m_depth = 64;
+
+	// result rows [begin, end) of (*this) * rhs
+	void m_mul(const Matrix <M>& rhs, Matrix <M>& result, size_t begin, size_t end) const {
+		const unsigned long long mod = M::mod();
+		const unsigned long long max_term = (mod - 1) * (mod - 1);
+		// lanes are kept below cap, the largest multiple of mod^2 up to 2^63, so lazy more products cannot overflow
+		// and a single conditional subtraction of cap brings a lane back below it
+		const unsigned long long cap = (1ULL << 63) / (mod * mod) * (mod * mod);
+		const size_t lazy = max_term ? cap / max_term : ~static_cast <size_t> (0);
+		unsigned long long acc[m_height][m_block];
+		size_t pending[m_height];
+		for (size_t ib = begin; ib < end; ib += m_height) {
+			const size_t height = std::min(m_height, end - ib);
+			for (size_t jb = 0; jb < rhs.m_cols; jb += m_block) {
+				const size_t width = std::min(m_block, rhs.m_cols - jb);
+				for (size_t i = 0; i < height; i++) {
+					std::fill(acc[i], acc[i] + width, 0ULL);
+					pending[i] = 0;
+				}
+				for (size_t kb = 0; kb < this->m_cols; kb += m_depth) {
+					const size_t depth = std::min(m_depth, this->m_cols - kb);
+					for (size_t i = 0; i < height; i++) {
+						const M* row = (*this)[ib + i] + kb;
+						unsigned long long* lane = acc[i];
+						for (size_t k = 0; k < depth; k++) {
+							const unsigned long long a = static_cast <unsigned int> ((int) row[k]);
+							if (!a) [[unlikely]] {
+								continue;
+							}
+							const M* other = rhs[kb + k] + jb;
+							for (size_t j = 0; j < width; j++) {
+								lane[j] += a * static_cast <unsigned int> ((int) other[j]);
+							}
+							if (++pending[i] == lazy) [[unlikely]] {
+								for (size_t j = 0; j < width; j++) {
+									lane[j] -= lane[j] >= cap ? cap : 0;
+								}
+								pending[i] = 0;
+							}
+						}
+					}
+				}
+				for (size_t i = 0; i < height; i++) {
+					M* out = result[ib + i] + jb;
+					for (size_t j = 0; j < width; j++) {
+						out[j] = M(acc[i][j] % mod);
+					}
+				}
+			}
+		}
+	}
+
+	size_t m_find_pivot(size_t row, size_t col) const noexcept {
+		for (size_t i = row; i < this->m_rows; i++) {
+			if ((*this)[i][col] != M(0)) {
+				return i;
+			}
+		}
+		return this->m_rows;
+	}
+
+	void m_swap_rows(size_t row0, size_t row1) noexcept {
+		if (row0 != row1) {
+			std::swap_ranges((*this)[row0], (*this)[row0] + this->m_cols, (*this)[row1]);
+		}
+	}
+
+	// clears column col below (and above if full) the pivot at (row, col), full also normalizes the pivot row
+	void m_eliminate(size_t row, size_t col, bool full) noexcept {
+		M* pivot = (*this)[row];
+		const M ip = inverse(pivot[col]);
+		if (full) {
+			for (size_t j = col; j < this->m_cols; j++) {
+				pivot[j] *= ip;
+			}
+		}
+		for (size_t i = full ? 0 : row + 1; i < this->m_rows; i++) {
+			if (i == row || (*this)[i][col] == M(0)) {
+				continue;
+			}
+			M* other = (*this)[i];
+			const M factor = full ? other[col] : other[col] * ip;
+			for (size_t j = col; j < this->m_cols; j++) {
+				other[j] -= factor * pivot[j];
+			}
+		}
+	}
+
+};
@@ -0,0 +1,338 @@
+#pragma once
+
+#include "inverse.h"
+#include "montgomery.h"
+
+#include <iostream>
+#include <cassert>
+#include <type_traits>
+
+// mod int for (odd) moduli up to 2^64, values are kept in montgomery form
+template <unsigned long long MOD, bool IS_PRIME = false> class Mint64 {
+
+	static_assert(MOD & 1, "Mint64 requires an odd modulus");
+
+public:
+
+	constexpr Mint64() noexcept : m_value(0) { }
+	template <typename A> constexpr Mint64(const A& _value) noexcept : m_value(m_mont.to(m_mont.fix(_value))) { }
+	constexpr Mint64(const Mint64& _mint) noexcept : m_value(_mint.m_value) { }
+
+	constexpr Mint64 <MOD, IS_PRIME>& operator = (const Mint64 <MOD, IS_PRIME>& rhs) noexcept {
+		this->m_value = rhs.m_value;
+		return *this;
+	}
+
+	constexpr explicit operator unsigned long long () const noexcept {
+		return m_mont.from(this->m_value);
+	}
+
+	static constexpr unsigned long long mod() noexcept {
+		return MOD;
+	}
+
+	constexpr bool operator == (const Mint64 <MOD, IS_PRIME>& rhs) const noexcept {
+		return this->m_value == rhs.m_value;
+	}
+
+	constexpr bool operator != (const Mint64 <MOD, IS_PRIME>& rhs) const noexcept {
+		return !(*this == rhs);
+	}
+
+	constexpr std::strong_ordering operator <=> (const Mint64 <MOD, IS_PRIME>& rhs) const noexcept {
+		return (unsigned long long) *this < (unsigned long long) rhs ? std::strong_ordering::less :
+		(unsigned long long) *this > (unsigned long long) rhs ? std::strong_ordering::greater : std::strong_ordering::equivalent;
+	}
+
+	constexpr Mint64 <MOD, IS_PRIME> operator - () const noexcept {
+		return Mint64 <MOD, IS_PRIME> () - *this;
+	}
+
+	constexpr Mint64 <MOD, IS_PRIME>& operator += (const Mint64 <MOD, IS_PRIME>& rhs) noexcept {
+		this->m_value = m_mont.add(this->m_value, rhs.m_value);
+		return *this;
+	}
+
+	constexpr Mint64 <MOD, IS_PRIME>& operator -= (const Mint64 <MOD, IS_PRIME>& rhs) noexcept {
+		this->m_value = m_mont.sub(this->m_value, rhs.m_value);
+		return *this;
+	}
+
+	constexpr Mint64 <MOD, IS_PRIME>& operator *= (const Mint64 <MOD, IS_PRIME>& rhs) noexcept {
+		this->m_value = m_mont.mul(this->m_value, rhs.m_value);
+		return *this;
+	}
+
+	constexpr Mint64 <MOD, IS_PRIME>& operator /= (const Mint64 <MOD, IS_PRIME>& rhs) noexcept {
+		return *this *= inverse(rhs);
+	}
+
+	// zero if the value is not invertible
+	friend constexpr Mint64 <MOD, IS_PRIME> inverse(const Mint64 <MOD, IS_PRIME>& den) noexcept {
+		const unsigned long long value = (unsigned long long) den;
+		if (!value) [[unlikely]] {
+			return Mint64 <MOD, IS_PRIME> ();
+		}
+		return Mint64 <MOD, IS_PRIME> (m_inverse(value));
+	}
+
+	template <typename A> static constexpr Mint64 <MOD, IS_PRIME> pow(Mint64 <MOD, IS_PRIME> base, A exponent) noexcept {
+		static_assert(std::is_integral_v <A>);
+		if (exponent < static_cast <A> (0)) {
+			return pow(inverse(base), -(exponent + static_cast <A> (1))) * inverse(base);
+		}
+		if constexpr (IS_PRIME) {
+			if (static_cast <unsigned long long> (exponent) >= MOD - 1) {
+				exponent %= MOD - 1;
+			}
+		}
+		Mint64 <MOD, IS_PRIME> result(1);
+		while (exponent) {
+			if (exponent & static_cast <A> (1)) {
+				result *= base;
+			}
+			exponent >>= static_cast <A> (1);
+			base *= base;
+		}
+		return result;
+	}
+
+	constexpr Mint64 <MOD, IS_PRIME>& operator ++ () noexcept {
+		return *this += 1;
+	}
+
+	constexpr Mint64 <MOD, IS_PRIME> operator ++ (int) noexcept {
+		Mint64 <MOD, IS_PRIME> result = *this;
+		++*this;
+		return result;
+	}
+
+	constexpr Mint64 <MOD, IS_PRIME>& operator -- () noexcept {
+		return *this -= 1;
+	}
+
+	constexpr Mint64 <MOD, IS_PRIME> operator -- (int) noexcept {
+		Mint64 <MOD, IS_PRIME> result = *this;
+		--*this;
+		return result;
+	}
+
+	friend constexpr Mint64 <MOD, IS_PRIME> operator + (Mint64 <MOD, IS_PRIME> mint, const Mint64 <MOD, IS_PRIME>& other) noexcept {
+		return mint += other;
+	}
+
+	friend constexpr Mint64 <MOD, IS_PRIME> operator - (Mint64 <MOD, IS_PRIME> mint, const Mint64 <MOD, IS_PRIME>& other) noexcept {
+		return mint -= other;
+	}
+
+	friend constexpr Mint64 <MOD, IS_PRIME> operator * (Mint64 <MOD, IS_PRIME> mint, const Mint64 <MOD, IS_PRIME>& other) noexcept {
+		return mint *= other;
+	}
+
+	friend constexpr Mint64 <MOD, IS_PRIME> operator / (Mint64 <MOD, IS_PRIME> mint, const Mint64 <MOD, IS_PRIME>& other) noexcept {
+		return mint /= other;
+	}
+
+	friend std::ostream& operator << (std::ostream& stream, const Mint64 <MOD, IS_PRIME>& mint) {
+		return stream << (unsigned long long) mint;
+	}
+
+	friend std::istream& operator >> (std::istream& stream, Mint64 <MOD, IS_PRIME>& mint) {
+		long long i64v;
+		stream >> i64v;
+		mint = Mint64 <MOD, IS_PRIME> (i64v);
+		return stream;
+	}
+
+private:
+
+	unsigned long long m_value;
+
+	static constexpr const Montgomery64 m_mont = Montgomery64(MOD);
+
+	// extended euclid on a in [1, MOD), kept local since inverse() from inverse.h is not constexpr, 0 if not invertible
+	static constexpr unsigned long long m_inverse(unsigned long long a) noexcept {
+		__int128 r0 = a, r1 = MOD, x0 = 1, x1 = 0;
+		while (r1) {
+			const __int128 quo = r0 / r1;
+			__int128 t = r0 - quo * r1;
+			r0 = r1;
+			r1 = t;
+			t = x0 - quo * x1;
+			x0 = x1;
+			x1 = t;
+		}
+		if (r0 != 1) {
+			return 0;
+		}
+		return static_cast <unsigned long long> (x0 < 0 ? x0 + static_cast <__int128> (MOD) : x0);
+	}
+
+};
+
+// Mint64 with the (odd) modulus chosen at runtime
+// every thread has its own modulus per ID, use different IDs to work under several moduli at once
+template <int ID = 0> class Dmint64 {
+
+	struct Context;
+
+public:
+
+	Dmint64() noexcept : m_value(0) { }
+	template <typename A> Dmint64(const A& _value) noexcept : m_value(m_mont.to(m_mont.fix(_value))) { }
+	Dmint64(const Dmint64& _mint) noexcept : m_value(_mint.m_value) { }
+
+	Dmint64 <ID>& operator = (const Dmint64 <ID>& rhs) noexcept {
+		this->m_value = rhs.m_value;
+		return *this;
+	}
+
+	explicit operator unsigned long long () const noexcept {
+		return m_mont.from(this->m_value);
+	}
+
+	static unsigned long long mod() noexcept {
+		return m_mont.mod;
+	}
+
+	// all existing values become meaningless
+	static void set_mod(unsigned long long mod, bool is_prime = false) noexcept {
+		assert(mod & 1);
+		m_mont = Montgomery64(mod);
+		m_is_prime = is_prime;
+	}
+
+	// the modulus of the calling thread, set_context() installs it on another thread (e.g. the workers of a parallel routine)
+	static Context context() noexcept {
+		return { m_mont, m_is_prime };
+	}
+
+	static void set_context(const Context& ctx) noexcept {
+		m_mont = ctx.mont;
+		m_is_prime = ctx.is_prime;
+	}
+
+	bool operator == (const Dmint64 <ID>& rhs) const noexcept {
+		return this->m_value == rhs.m_value;
+	}
+
+	bool operator != (const Dmint64 <ID>& rhs) const noexcept {
+		return !(*this == rhs);
+	}
+
+	std::strong_ordering operator <=> (const Dmint64 <ID>& rhs) const noexcept {
+		return (unsigned long long) *this < (unsigned long long) rhs ? std::strong_ordering::less :
+		(unsigned long long) *this > (unsigned long long) rhs ? std::strong_ordering::greater : std::strong_ordering::equivalent;
+	}
+
+	Dmint64 <ID> operator - () const noexcept {
+		return Dmint64 <ID> () - *this;
+	}
+
+	Dmint64 <ID>& operator += (const Dmint64 <ID>& rhs) noexcept {
+		this->m_value = m_mont.add(this->m_value, rhs.m_value);
+		return *this;
+	}
+
+	Dmint64 <ID>& operator -= (const Dmint64 <ID>& rhs) noexcept {
+		this->m_value = m_mont.sub(this->m_value, rhs.m_value);
+		return *this;
+	}
+
+	Dmint64 <ID>& operator *= (const Dmint64 <ID>& rhs) noexcept {
+		this->m_value = m_mont.mul(this->m_value, rhs.m_value);
+		return *this;
+	}
+
+	Dmint64 <ID>& operator /= (const Dmint64 <ID>& rhs) noexcept {
+		return *this *= inverse(rhs);
+	}
+
+	// zero if the value is not invertible
+	friend Dmint64 <ID> inverse(const Dmint64 <ID>& den) noexcept {
+		const unsigned long long value = (unsigned long long) den;
+		if (!value) [[unlikely]] {
+			return Dmint64 <ID> ();
+		}
+		return Dmint64 <ID> (inverse <__int128> (value, m_mont.mod));
+	}
+
+	template <typename A> static Dmint64 <ID> pow(Dmint64 <ID> base, A exponent) noexcept {
+		static_assert(std::is_integral_v <A>);
+		if (exponent < static_cast <A> (0)) {
+			return pow(inverse(base), -(exponent + static_cast <A> (1))) * inverse(base);
+		}
+		if (m_is_prime && static_cast <unsigned long long> (exponent) >= m_mont.mod - 1) {
+			exponent %= m_mont.mod - 1;
+		}
+		Dmint64 <ID> result(1);
+		while (exponent) {
+			if (exponent & static_cast <A> (1)) {
+				result *= base;
+			}
+			exponent >>= static_cast <A> (1);
+			base *= base;
+		}
+		return result;
+	}
+
+	Dmint64 <ID>& operator ++ () noexcept {
+		return *this += 1;
+	}
+
+	Dmint64 <ID> operator ++ (int) noexcept {
+		Dmint64 <ID> result = *this;
+		++*this;
+		return result;
+	}
+
+	Dmint64 <ID>& operator -- () noexcept {
+		return *this -= 1;
+	}
+
+	Dmint64 <ID> operator -- (int) noexcept {
+		Dmint64 <ID> result = *this;
+		--*this;
+		return result;
+	}
+
+	friend Dmint64 <ID> operator + (Dmint64 <ID> mint, const Dmint64 <ID>& other) noexcept {
+		return mint += other;
+	}
+
+	friend Dmint64 <ID> operator - (Dmint64 <ID> mint, const Dmint64 <ID>& other) noexcept {
+		return mint -= other;
+	}
+
+	friend Dmint64 <ID> operator * (Dmint64 <ID> mint, const Dmint64 <ID>& other) noexcept {
+		return mint *= other;
+	}
+
+	friend Dmint64 <ID> operator / (Dmint64 <ID> mint, const Dmint64 <ID>& other) noexcept {
+		return mint /= other;
+	}
+
+	friend std::ostream& operator << (std::ostream& stream, const Dmint64 <ID>& mint) {
+		return stream << (unsigned long long) mint;
+	}
+
+	friend std::istream& operator >> (std::istream& stream, Dmint64 <ID>& mint) {
+		long long i64v;
+		stream >> i64v;
+		mint = Dmint64 <ID> (i64v);
+		return stream;
+	}
+
+private:
+
+	unsigned long long m_value;
+
+	struct Context {
+		Montgomery64 mont;
+		bool is_prime;
+	};
+
+	static inline thread_local Montgomery64 m_mont = Montgomery64((1ULL << 61) - 1);
+	static inline thread_local bool m_is_prime = true;
+
+};
@@ -0,0 +1,222 @@
+#pragma once
+
+#include "factor_core.h"
+
+#include <vector>
+#include <cmath>
+#include <numeric>
+#include <utility>
+
+// discrete logarithms, square roots and primitive roots for a mod int type M (e.g. Mint, Dmint)
+// log() works for any modulus, sqrt() requires a prime modulus, primitive_root() finds one whenever it exists
+template <typename M> class Modular {
+
+	using value_type = unsigned long long;
+
+public:
+
+	// smallest x >= 0 with a^x = b, -1 if there is none
+	// baby step giant step in O(sqrt(mod)), common factors of a and the modulus are divided out first
+	static long long log(const M& a, const M& b) {
+		value_type mod = M::mod(), x = static_cast <unsigned int> ((int) a), y = static_cast <unsigned int> ((int) b);
+		if (mod == 1) [[unlikely]] {
+			return 0;
+		}
+		// a^shift * factor * a^(x - shift) = y with gcd(a, mod) = 1 after the loop
+		value_type factor = 1, shift = 0;
+		for (value_type g = std::gcd(x, mod); g != 1; g = std::gcd(x, mod)) {
+			if (y == factor) {
+				return shift;
+			}
+			if (y % g) {
+				return -1;
+			}
+			y /= g;
+			mod /= g;
+			shift++;
+			factor = factor * (x / g) % mod;
+			x %= mod;
+			y %= mod;
+		}
+		const value_type n = static_cast <value_type> (std::sqrt(static_cast <double> (mod))) + 1;
+		// baby steps y * a^j for 0 <= j <= n, the largest j wins so the first giant step hit is the smallest x
+		Table table(n + 1);
+		value_type step = 1;
+		for (value_type j = 0, value = y; j <= n; j++) {
+			table.insert(static_cast <unsigned int> (value), static_cast <unsigned int> (j));
+			value = value * x % mod;
+			step = j < n ? step * x % mod : step;
+		}
+		for (value_type i = 1, value = factor; i <= n; i++) {
+			value = value * step % mod;
+			const long long j = table.find(static_cast <unsigned int> (value));
+			if (j >= 0) [[unlikely]] {
+				return static_cast <long long> (i * n + shift) - j;
+			}
+		}
+		return -1;
+	}
+
+	// some root of a written to result, false if a is not a quadratic residue
+	// tonelli-shanks when 2^s, the power of two in mod - 1, is small and cipolla otherwise
+	static bool sqrt(const M& a, M& result) noexcept {
+		if (a == M(0) || M::mod() == 2) [[unlikely]] {
+			result = a;
+			return true;
+		}
+		const int half = (M::mod() - 1) >> 1;
+		if (M::pow(a, half) != M(1)) {
+			return false;
+		}
+		if (__builtin_ctz(M::mod() - 1) <= m_tonelli_max_s) {
+			result = m_tonelli_shanks(a);
+		} else {
+			result = m_cipolla(a);
+		}
+		return true;
+	}
+
+	// smallest primitive root, -1 if the group of units is not cyclic (the modulus is not 1, 2, 4, p^k or 2p^k)
+	static int primitive_root() {
+		const value_type mod = M::mod();
+		if (mod <= 4) [[unlikely]] {
+			return mod == 1 ? 0 : static_cast <int> (mod - 1);
+		}
+		const std::vector <std::pair <value_type, int>> factors = Factor::factorize(mod);
+		if (factors.size() > 2 || (factors.size() == 2 && (factors[0].first != 2 || factors[0].second != 1)) || (factors.size() == 1 && factors[0].first == 2)) {
+			return -1;
+		}
+		const value_type totient = Factor::phi(mod);
+		const std::vector <std::pair <value_type, int>> totient_factors = Factor::factorize(totient);
+		for (value_type g = 2; g < mod; g++) {
+			if (std::gcd(g, mod) != 1) {
+				continue;
+			}
+			bool generator = true;
+			for (const std::pair <value_type, int>& q : totient_factors) {
+				if (M::pow(M(g), static_cast <long long> (totient / q.first)) == M(1)) {
+					generator = false;
+					break;
+				}
+			}
+			if (generator) {
+				return static_cast <int> (g);
+			}
+		}
+		return -1;
+	}
+
+private:
+
+	static constexpr const int m_tonelli_max_s = 8;
+
+	// open addressing from unsigned keys to unsigned values, sized to the number of insertions up front
+	class Table {
+
+	public:
+
+		Table(size_t _count) : m_shift(64), m_keys(), m_values() {
+			size_t capacity = 1;
+			while (capacity < (_count << 1)) {
+				capacity <<= 1;
+				this->m_shift--;
+			}
+			this->m_keys.assign(capacity, m_empty);
+			this->m_values.resize(capacity);
+		}
+
+		void insert(unsigned int key, unsigned int value) noexcept {
+			size_t i = this->m_slot(key);
+			while (this->m_keys[i] != m_empty && this->m_keys[i] != key) {
+				i = (i + 1) & (this->m_keys.size() - 1);
+			}
+			this->m_keys[i] = key;
+			this->m_values[i] = value;
+		}
+
+		// -1 if missing
+		long long find(unsigned int key) const noexcept {
+			for (size_t i = this->m_slot(key); this->m_keys[i] != m_empty; i = (i + 1) & (this->m_keys.size() - 1)) {
+				if (this->m_keys[i] == key) {
+					return this->m_values[i];
+				}
+			}
+			return -1;
+		}
+
+	private:
+
+		// keys are residues below 2^31, so this never collides with a real key
+		static constexpr const unsigned int m_empty = ~0U;
+
+		int m_shift;
+		std::vector <unsigned int> m_keys;
+		std::vector <unsigned int> m_values;
+
+		size_t m_slot(unsigned int key) const noexcept {
+			return this->m_shift == 64 ? 0 : static_cast <size_t> ((key * 0x9e3779b97f4a7c15ULL) >> this->m_shift);
+		}
+
+	};
+
+	// a must be a non zero quadratic residue
+	static M m_tonelli_shanks(const M& a) noexcept {
+		int s = __builtin_ctz(M::mod() - 1);
+		const int q = (M::mod() - 1) >> s;
+		M z = 2;
+		while (M::pow(z, (M::mod() - 1) >> 1) == M(1)) {
+			z += M(1);
+		}
+		M c = M::pow(z, q), t = M::pow(a, q);
+		M result = M::pow(a, (q + 1) >> 1);
+		while (t != M(1)) {
+			int i = 0;
+			for (M tt = t; tt != M(1); tt *= tt) {
+				i++;
+			}
+			M b = c;
+			for (int j = 0; j < s - i - 1; j++) {
+				b *= b;
+			}
+			s = i;
+			c = b * b;
+			t *= c;
+			result *= b;
+		}
+		return result;
+	}
+
+	// a must be a non zero quadratic residue, computes (t + sqrt(t^2 - a))^((mod + 1) / 2) in F_mod[sqrt(t^2 - a)]
+	static M m_cipolla(const M& a) noexcept {
+		M t = 1, w = -a + M(1);
+		while (M::pow(w, (M::mod() - 1) >> 1) == M(1)) {
+			t += M(1);
+			w = t * t - a;
+		}
+		M x0 = 1, x1 = 0, y0 = t, y1 = 1;
+		for (int e = (M::mod() + 1) >> 1; e; e >>= 1) {
+			if (e & 1) {
+				const M r0 = x0 * y0 + x1 * y1 * w;
+				x1 = x0 * y1 + x1 * y0;
+				x0 = r0;
+			}
+			const M r0 = y0 * y0 + y1 * y1 * w;
+			y1 = (y0 * y1) * M(2);
+			y0 = r0;
+		}
+		return x0;
+	}
+
+};
+
+template <typename M> inline long long discrete_log(const M& a, const M& b) {
+	return Modular <M>::log(a, b);
+}
+
+template <typename M> inline bool mod_sqrt(const M& a, M& result) noexcept {
+	return Modular <M>::sqrt(a, result);
+}
+
+template <typename M> inline int primitive_root() {
+	return Modular <M>::primitive_root();
+}
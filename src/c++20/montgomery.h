@@ -0,0 +1,74 @@
+#pragma once
+
+// montgomery arithmetic modulo an odd 64-bit modulus with R = 2^64
+struct Montgomery64 {
+
+	unsigned long long mod;
+	// mod^-1 mod 2^64
+	unsigned long long inv;
+	// R^2 mod mod
+	unsigned long long r2;
+
+	constexpr Montgomery64(unsigned long long _mod = 1) noexcept :
+	mod(_mod),
+	inv(m_inv(_mod)),
+	r2(static_cast <unsigned long long> ((~static_cast <unsigned __int128> (0) % _mod + 1) % _mod))
+	{ }
+
+	// x * R^-1 mod mod, requires x < mod * R
+	constexpr unsigned long long reduce(unsigned __int128 x) const noexcept {
+		const unsigned long long q = static_cast <unsigned long long> (x) * this->inv;
+		const unsigned long long h = static_cast <unsigned long long> (x >> 64);
+		const unsigned long long l = static_cast <unsigned long long> ((static_cast <unsigned __int128> (q) * this->mod) >> 64);
+		return h - l + (h < l ? this->mod : 0);
+	}
+
+	constexpr unsigned long long mul(unsigned long long a, unsigned long long b) const noexcept {
+		return this->reduce(static_cast <unsigned __int128> (a) * b);
+	}
+
+	// requires x < mod
+	constexpr unsigned long long to(unsigned long long x) const noexcept {
+		return this->mul(x, this->r2);
+	}
+
+	constexpr unsigned long long from(unsigned long long x) const noexcept {
+		return this->reduce(x);
+	}
+
+	constexpr unsigned long long add(unsigned long long a, unsigned long long b) const noexcept {
+		const unsigned long long result = a + b;
+		return result < a || result >= this->mod ? result - this->mod : result;
+	}
+
+	constexpr unsigned long long sub(unsigned long long a, unsigned long long b) const noexcept {
+		return a - b + (a < b ? this->mod : 0);
+	}
+
+	// reduces any integral value into [0, mod)
+	template <typename A> constexpr unsigned long long fix(A value) const noexcept {
+		if constexpr (static_cast <A> (-1) < static_cast <A> (0)) {
+			if (value < static_cast <A> (0)) {
+				const unsigned long long result = static_cast <unsigned long long> ((static_cast <unsigned __int128> (-(value + 1)) + 1) % this->mod);
+				return result ? this->mod - result : 0;
+			}
+		}
+		if constexpr (sizeof(A) > sizeof(unsigned long long)) {
+			return static_cast <unsigned long long> (static_cast <unsigned __int128> (value) % this->mod);
+		} else {
+			return static_cast <unsigned long long> (value) % this->mod;
+		}
+	}
+
+private:
+
+	static constexpr unsigned long long m_inv(unsigned long long x) noexcept {
+		// x * x = 1 mod 8 for odd x, every newton step doubles the number of correct bits
+		unsigned long long result = x;
+		for (int i = 0; i < 5; i++) {
+			result *= 2 - x * result;
+		}
+		return result;
+	}
+
+};
@@ -1,14 +1,24 @@
 #pragma once
 
+#include "factor_core.h"
+
+// values up to 64 bits are factorized with pollard's rho, wider types fall back to trial division
 template <typename A> constexpr A phi(A x) noexcept {
-	A result = x;
-	for (A i = static_cast <A> (2); i * i <= x; i++) {
-		if (!(x % i)) {
-			while (!(x % i)) {
-				x /= i;
+	if constexpr (sizeof(A) <= sizeof(unsigned long long)) {
+		if (x < static_cast <A> (2)) {
+			return x;
+		}
+		return static_cast <A> (Factor::phi(static_cast <unsigned long long> (x)));
+	} else {
+		A result = x;
+		for (A i = static_cast <A> (2); i * i <= x; i++) {
+			if (!(x % i)) {
+				while (!(x % i)) {
+					x /= i;
+				}
+				result -= result / i;
 			}
-			result -= result / i;
 		}
+		return x > static_cast <A> (1) ? result - result / x : result;
 	}
-	return x > static_cast <A> (1) ? result - result / x : result;
 }